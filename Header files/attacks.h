@@ -0,0 +1,63 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include "bitboard.h"
+
+// Precomputed sliding-piece attacks (magic bitboards).
+// Each square has a mask of the squares whose occupancy matters; the occupancy under
+// that mask is hashed to an index into a per-square table of attack sets. The hash is a
+// multiply-and-shift by a "magic" number, or a single PEXT instruction when the CPU
+// supports BMI2 (chosen once when the tables are built).
+struct Magic {
+    Bitboard mask;       // Relevant occupancy squares (board edges excluded)
+    Bitboard magic;      // Multiplier for the magic index
+    Bitboard* attacks;   // Start of this square's slice of the attack table
+    unsigned shift;      // 64 - number of bits in mask
+
+    unsigned index(Bitboard occupied) const;
+};
+
+extern Magic rookMagics[64];
+extern Magic bishopMagics[64];
+extern bool usePext;
+
+// Knight, king and pawn attacks do not depend on occupancy, so they are a plain lookup
+extern Bitboard knightAttackTable[64];
+extern Bitboard kingAttackTable[64];
+extern Bitboard pawnAttackTable[2][64];  // Squares a pawn of each colour captures on, by colourIndex()
+
+// Geometry between two squares on a common rank, file or diagonal (empty if they share none)
+extern Bitboard betweenTable[64][64];  // Squares strictly between the two
+extern Bitboard lineTable[64][64];     // The whole line through both, edge to edge
+
+unsigned pextIndex(Bitboard occupied, Bitboard mask);  // Only called when usePext is set
+
+inline unsigned Magic::index(Bitboard occupied) const {
+    if (usePext) return pextIndex(occupied, mask);
+    return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+}
+
+void initAttacks();           // Builds the tables; safe to call more than once
+bool verifySlidingAttacks();  // Compares the tables against a square-by-square ray walk
+
+inline Bitboard rookAttacks(int square, Bitboard occupied) {
+    const Magic& m = rookMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+    const Magic& m = bishopMagics[square];
+    return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int square, Bitboard occupied) {
+    return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+}
+
+inline Bitboard knightAttacks(int square) { return knightAttackTable[square]; }
+inline Bitboard kingAttacks(int square) { return kingAttackTable[square]; }
+inline Bitboard pawnAttacks(Colour colour, int square) { return pawnAttackTable[colourIndex(colour)][square]; }
+inline Bitboard betweenSquares(int a, int b) { return betweenTable[a][b]; }
+inline Bitboard lineThrough(int a, int b) { return lineTable[a][b]; }
+
+#endif // ATTACKS_H
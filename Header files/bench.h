@@ -0,0 +1,9 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Searches a fixed set of positions to a fixed depth on 1, 2, 4, ... up to maxThreads
+// threads and prints time, nodes, nodes/sec and the speedup over one thread.
+// Each position starts from an empty transposition table of hashMB megabytes.
+void runBench(int maxThreads, int depth, int hashMB, int evalCacheMB);
+
+#endif // BENCH_H
@@ -0,0 +1,42 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include "position.h"
+#include "colour.h"
+#include "pieceType.h"
+
+// A bitboard is a set of squares, one bit per square.
+// Squares are numbered a1 = 0, b1 = 1, ... h1 = 7, a2 = 8, ... h8 = 63.
+typedef uint64_t Bitboard;
+
+// A piece is its colour and type packed into one byte (colour * 6 + type, see pieceIndex below),
+// so the mailbox and undo stack store it directly and move rules switch on it
+typedef int8_t PieceCode;
+const int NO_PIECE = -1;  // Empty square in the board's piece index table
+
+const Bitboard FILE_A = 0x0101010101010101ULL;
+const Bitboard FILE_H = FILE_A << 7;
+const Bitboard RANK_1 = 0xFFULL;
+const Bitboard RANK_8 = RANK_1 << 56;
+
+// Conversions between Position (1-indexed row/col) and square numbers
+inline int toSquare(const Position& pos) { return (pos.getRow() - 1) * 8 + (pos.getCol() - 1); }
+inline Position toPosition(int square) { return Position(square / 8 + 1, square % 8 + 1); }
+inline Bitboard squareBB(int square) { return 1ULL << square; }
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }  // b must not be empty
+inline int popLsb(Bitboard& b) {  // Returns and clears the lowest set square
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+// Piece indices 0-5 are white pawn..king, 6-11 are black pawn..king
+inline int colourIndex(Colour colour) { return colour == Colour::WHITE ? 0 : 1; }
+inline int pieceIndex(Colour colour, PieceType type) { return colourIndex(colour) * 6 + static_cast<int>(type); }
+inline Colour colourOfIndex(int index) { return index < 6 ? Colour::WHITE : Colour::BLACK; }
+inline PieceType typeOfIndex(int index) { return static_cast<PieceType>(index % 6); }
+
+#endif // BITBOARD_H
@@ -1,10 +1,17 @@
 // board.h – Basic Board interface for CS246 Chess
+#ifndef BOARD_H
+#define BOARD_H
 
 #include "position.h"
 #include "colour.h"
 #include "piece.h"
+#include "bitboard.h"
+#include "zobrist.h"
+#include "pieceSquareTables.h"
+#include "move.h"
 #include <vector>
 #include <memory>
+#include <string>
 
 // Forward declarations
 class ChessDisplay;
@@ -14,6 +21,8 @@ class Board {
     friend class Player;  // Allow Player to access private members for AI logic
 public:
     Board();
+    Board(const Board& other);             // Copies the position and undo history but not the observers, so a search thread can own a copy
+    Board& operator=(const Board&) = delete;
     ~Board();
 
     void setupStartingPosition();   //sets up boards starting chess position
@@ -21,6 +30,7 @@ public:
     void resetSpecialRules();       // resets all flags for enpassant castling etc. back to false when starting a new game, takes care of any other special rules too
 
     bool isInCheck(Colour colour) const;  // checks if the current player is facing a check.
+    bool isSquareAttacked(int square, Colour byColour) const;  // Looks outward from square for byColour's attackers: a few table lookups, no piece walks
     bool canCastleKingSide(Colour colour) const;
     bool canCastleQueenSide(Colour colour) const;
     bool isEnPassant(const Position& from, const Position& to, Colour turn) const;
@@ -28,27 +38,86 @@ public:
     bool isValidMove(const Position& from, const Position& to, Colour turn) const;    // make sure its the current players turn and they have a piece at curr
                                                                                       // make sure dest is not occupied by current player's own piece
                                                                                       // makes sure user if hes not making the pieces move agaisnt their behaviour ex. making queen move like knig
-    bool wouldBeInCheck(const Position& from, const Position& to, Colour turn) const; 
-    void makeMove(const Position& from, const Position& to, char promotion);    // make move will first check if the user is not retarded (hes not trying to promote the wrong thing)
+    Bitboard moveTargets(int square) const;  // Squares the piece on square can move to, ignoring checks (castling included); one switch on its type
+    bool wouldBeInCheck(const Position& from, const Position& to, Colour turn) const;  // Answered from the bitboards; the board is not touched
+    bool givesCheck(Move move) const;  // Would the move put the other side in check
+
+    // Static exchange evaluation: the material the mover ends up with once every capture on the
+    // move's destination has been traded off, each side using its least valuable attacker and
+    // free to stop when going on would lose. Sliders behind a capturing piece join in as it
+    // leaves (x-rays). Worked out from attack sets alone; nothing is played on the board.
+    // values is the worth of each PieceType, e.g. PIECE_WORTH or the evaluation's pieceValues.
+    int see(Move move, const int values[6]) const;
+    int threatenedLoss(int square, const int values[6]) const;  // What the piece on square loses if the enemy starts capturing it, 0 if it is safe
+    void makeMove(Move move);    // make move will first check if the user is not retarded (hes not trying to promote the wrong thing)
                                                                                // executes the move and makes the promotion if possible 
                                                                                // make move will also use removePiece from the board function to handle any removal of pieces.
 
+    // Reversible move execution for simulating moves: handles castling, en passant and promotion
+    // exactly, allocates nothing and does not notify observers. Every doMove must be matched by an undoMove.
+    void doMove(Move move);
+    void undoMove();
+
+    // Builds the Move for a from/to pair (and promotion piece, queen if '\0') in this position,
+    // working out whether it castles, captures en passant or promotes. Does not check legality.
+    Move moveFor(const Position& from, const Position& to, char promotion) const;
+
+    // Every legal move for colour. Checkers and pinned pieces are worked out once, so nothing
+    // is played to test it (apart from the rare en passant capture). Promotions come as four
+    // moves, queen first.
+    void generateLegalMoves(Colour colour, std::vector<Move>& moves) const;
+    // Only the legal captures (en passant included) and queen promotions, for the quiescence
+    // search; quiet moves are never generated
+    void generateLegalCaptures(Colour colour, std::vector<Move>& moves) const;
+    // Everything generateLegalCaptures leaves out: quiet moves, castling and under-promotions
+    void generateLegalQuiets(Colour colour, std::vector<Move>& moves) const;
+    bool isLegal(Move move) const;  // Is move legal for the side to move here, e.g. a move remembered from another position
+
     bool isInCheckmate(Colour colour) const;   // checks whether the current colour has been checkmated
     bool isInStalemate(Colour colour) const;   // checks whether the current colour is in stalemate or not
 
     void addPiece(char pieceChar, const Position& pos);   // Place a piece on pos in setup mode (replace any piece currently on pos)
     void removePiece(const Position& pos);                // Remove a piece from pos in setup mode ()
     int countPieces(char piece) const; // runs a loop over the entire board to count the number of piece pieces.
-    bool hasPawnsOnEndRanks();      //  checks for no pawns on first or last row 
+    bool hasPawnsOnEndRanks() const;      //  checks for no pawns on first or last row 
     bool isValidSetup() const;                            // Ensure setup meets rules
     void clear();  // Clear the board (used in setup) 
+    void setFen(const std::string& fen);  // Set up a position from FEN (move counters ignored); throws std::invalid_argument
 
     void init();   // (didnt see)                                           // Set up initial chessboard
                              
 
     
 
-    Piece* getPiece(const Position& pos) const;    //  (didnt see)     // Get piece at position
+    Piece* getPiece(const Position& pos) const;    //  (didnt see)     // Get piece at position (shared Piece object for that colour/type)
+
+    // Bitboard queries
+    Bitboard pieces(Colour colour, PieceType type) const { return pieceBB[pieceIndex(colour, type)]; }
+    Bitboard pieces(Colour colour) const { return colourBB[colourIndex(colour)]; }
+    Bitboard occupied() const { return occupiedBB; }
+    int pieceIndexAt(int square) const { return mailbox[square]; }  // NO_PIECE if empty
+
+    // Piece lists and counts come straight from the bitboards, which every move, addPiece,
+    // removePiece and clear keep up to date; iterate a side's pieces with popLsb(pieces(colour))
+    int kingSquare(Colour colour) const;  // -1 if that king is not on the board (setup mode)
+    int pieceCount(Colour colour, PieceType type) const { return popCount(pieces(colour, type)); }
+    int pieceCount(Colour colour) const { return popCount(pieces(colour)); }
+
+    // Position identity: Zobrist key of pieces, side to move, castling rights and en passant file
+    Key getKey() const { return key; }
+    Key computeKey() const;  // Full recompute, for checking the incremental key
+    Key getPawnKey() const { return pawnKey; }  // Zobrist key of the pawns alone, for the pawn hash table
+    Key computePawnKey() const;
+    Colour getSideToMove() const { return sideToMove; }
+    void setSideToMove(Colour colour);
+    int castlingRights() const;  // Bits: 1 white king-side, 2 white queen-side, 4 black king-side, 8 black queen-side
+    int enPassantFile() const;   // File (0-7) the side to move can capture en passant on, -1 if none
+
+    // Running evaluation terms, kept up to date by every piece change like the key:
+    // material plus piece-square sums (White's point of view) and the game phase
+    int midgameScore() const { return mgScore; }
+    int endgameScore() const { return egScore; }
+    int gamePhase() const { return phase; }  // MAX_PHASE with all pieces on, 0 with only kings and pawns
 
     // Observer pattern methods
     void addObserver(ChessDisplay* observer);
@@ -56,7 +125,24 @@ public:
     void notifyObservers() const;
 
 private:
-    std::vector<std::vector<std::unique_ptr<Piece>>> grid;  // 8x8 board, nullptr for empty squares
+    Bitboard pieceBB[12];   // One set per colour/type, indexed by pieceIndex()
+    Bitboard colourBB[2];   // All white pieces, all black pieces
+    Bitboard occupiedBB;    // Every occupied square
+    PieceCode mailbox[64];  // Piece on each square (NO_PIECE if empty), so getPiece is a single lookup
+
+    // Low-level square updates that keep the bitboards and mailbox in sync
+    void putPiece(int index, int square);
+    void removePieceAt(int square);
+    void movePiece(int from, int to);
+
+    // Whether kingColour's king would be attacked once the move is played, worked out on
+    // a copy of the piece bitboards so const callers never modify the board
+    bool kingAttackedAfter(Move move, Colour kingColour) const;
+    Bitboard attackersTo(int square, Bitboard occupancy) const;  // Pieces of both colours attacking square
+    Bitboard pinnedPieces(Colour colour, int kingSquare) const;   // colour's pieces that shield their king from a slider
+    enum class GenType { ALL, CAPTURES, QUIETS };
+    void generateMoves(Colour colour, std::vector<Move>& moves, GenType type) const;  // Shared body of the generators
+
     Position lastMoveFrom;  // Tracks the source from the last move
     Position lastMoveTo; // Tracks where the previous piece just moved on the board
     bool whiteKingMoved;
@@ -65,8 +151,40 @@ private:
     bool whiteRookQueenMoved;  // Queen-side rook
     bool blackRookKingMoved;
     bool blackRookQueenMoved;
+    Colour sideToMove;      // Flipped by every doMove; Game keeps it in step with its own turn
+    Key key;                // Updated incrementally by every piece, flag and turn change
+    Key pawnKey;            // Updated by every pawn change
+    int mgScore;            // Updated by every piece change, like key
+    int egScore;
+    int phase;
+    bool scoresMatch() const;  // Running evaluation terms agree with a full recompute (debug builds)
+
+    // Irreversible state saved by doMove so undoMove can restore it
+    struct StateInfo {
+        int from = 0;
+        int to = 0;
+        PieceCode movedIndex = NO_PIECE;      // Piece that moved (a pawn if this was a promotion)
+        PieceCode capturedIndex = NO_PIECE;
+        int capturedSquare = 0;         // Differs from 'to' for en passant
+        int rookFrom = -1;              // Rook squares when castling, -1 otherwise
+        int rookTo = -1;
+        Key key = 0;                    // Key before the move
+        Position lastMoveFrom{0, 0};
+        Position lastMoveTo{0, 0};
+        bool whiteKingMoved = false;
+        bool blackKingMoved = false;
+        bool whiteRookKingMoved = false;
+        bool whiteRookQueenMoved = false;
+        bool blackRookKingMoved = false;
+        bool blackRookQueenMoved = false;
+    };
+    static const int MAX_STATES = 256;  // Deepest line of doMove calls that can be undone
+    StateInfo states[MAX_STATES];
+    int stateCount;
     
     // Observer pattern
     std::vector<ChessDisplay*> observers;
 };
 
+#endif // BOARD_H
+
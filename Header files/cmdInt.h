@@ -3,6 +3,10 @@
 
 #include <string>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
 #include "game.h"
 #include "position.h"
 #include "textDisplay.h"
@@ -15,12 +19,46 @@ class CommandInterpreter {
     std::unique_ptr<TextDisplay> textDisplay;
     std::unique_ptr<GraphicalDisplay> graphicalDisplay;
     // bool setupMode = false;
+    int hashSizeMB = 16;  // Transposition table size applied to every new game
+    int evalCacheMB = 4;  // Eval cache size applied to every new game
+    int searchThreads = 1;  // Search threads for engine players, applied to every new game
+    std::shared_ptr<const NnueNetwork> network;  // Engine evaluator for every new game; null for the hand-written one
+
+    // Engine moves are searched on engineThread so input is still read while it thinks.
+    // Only stop, hint, status and resign (and the move that answers a ponder) are answered during
+    // the search; every other command waits for the engine's move first, so the game is never
+    // touched by two threads at once.
+    std::thread engineThread;
+    std::atomic<bool> engineThinking{false};  // Cleared by the worker once its move is played
+    std::atomic<bool> stopEngine{false};      // Ends the search early; the best move so far is played
+    std::atomic<bool> abandonEngine{false};   // The search result is thrown away instead (resign)
+    Colour engineColour = Colour::WHITE;
+    std::mutex progressMutex;
+    std::chrono::steady_clock::time_point engineStart;  // Under progressMutex
+    SearchProgress engineProgress;  // Latest finished depth of the running search, under progressMutex
+
+    // Pondering: once the engine has moved against a human, the worker goes on to search the
+    // reply it expects. If that reply is played the search keeps going and becomes the engine's
+    // next move (a ponder hit); any other command drops it, keeping only its table entries.
+    bool ponderEnabled = true;
+    std::mutex engineMutex;                 // Orders starting a ponder against waitForEngine
+    bool ponderAllowed = false;             // Under engineMutex; cleared once input wants the game back
+    std::atomic<bool> pondering{false};     // Set by the worker once the ponder search is ready; cleared to start its clock
+    bool ponderHit = false;                 // The expected reply was played; the next move lets the engine finish
+    Move ponderMove;                        // Written before pondering is set, read after
+    PrincipalVariation ponderLine;
+    int ponderDepth = 0;
 
 public:
+    ~CommandInterpreter();
     void run();
 
 private:
     void handleCommand(const std::string& command);
+    bool handleEngineCommand(const std::string& command);  // stop, hint, status, resign; false for anything else
+    void startEngineMove();
+    bool startPonder(Move played, const SearchProgressCallback& report);  // Worker side, under engineMutex
+    void waitForEngine();
     Position converter(const std::string& str);
     void cleanup();
     void initializeDisplays();
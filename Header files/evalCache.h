@@ -0,0 +1,34 @@
+#ifndef EVALCACHE_H
+#define EVALCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "zobrist.h"
+
+// Cache of static evaluations by position key, kept apart from the transposition table so
+// leaf evaluations do not push out search results. The same leaf turns up again through
+// other move orders and at every new iteration, and this way it is evaluated only once.
+// Each entry is one relaxed 64-bit atomic holding the top 48 bits of the key and the 16-bit
+// score, so threads share it without locks. It is directly mapped and lossy: a store simply
+// overwrites whatever was in its slot.
+class EvalCache {
+public:
+    explicit EvalCache(int megabytes = 4);
+
+    void resize(int megabytes);  // Also clears the cache
+    void clear();
+
+    // Safe to call from several threads at once; hit statistics are kept by the caller
+    bool probe(Key key, int& score) const;
+    void store(Key key, int score);
+
+    int getSizeMB() const { return sizeMB; }
+
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> entries;
+    uint64_t entryMask;  // Entry count - 1
+    int sizeMB;
+};
+
+#endif // EVALCACHE_H
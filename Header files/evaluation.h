@@ -0,0 +1,14 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "pieceSquareTables.h"
+#include "pawnTable.h"
+
+class Board;
+
+// Static evaluation in centipawns from the side to move's point of view: material plus a
+// piece-square bonus for where each piece stands and the pawn structure (passed pawns scored
+// by how near each king is in the endgame too), tapered between middlegame and endgame. Pawn terms come from pawns when given, else are worked out afresh.
+int evaluate(const Board& board, PawnTable* pawns = nullptr);
+
+#endif // EVALUATION_H
@@ -3,8 +3,10 @@
 
 #include <string>
 #include <memory>
+#include <atomic>
 #include "player.h"
 #include "colour.h"
+#include "gameClock.h"
 
 
 // Within this file we will make use of everything inside board
@@ -12,21 +14,34 @@
 // Forward declarations
 class Board;
 class ChessDisplay;
+class TranspositionTable;
+class EvalCache;
+class PawnTables;
+class NnueNetwork;
 
 class Game {
 private:
     std::unique_ptr<Board> board;
     std::unique_ptr<Player> whitePlayer;
     std::unique_ptr<Player> blackPlayer;
+    std::unique_ptr<TranspositionTable> transpositionTable;  // Shared by the engine players, kept for the whole game
+    std::unique_ptr<EvalCache> evalCache;                    // Likewise
+    std::unique_ptr<PawnTables> pawnTables;                  // Likewise, one per search thread
+    std::shared_ptr<const NnueNetwork> network;              // Evaluator of the engine players; null for the hand-written one
     Colour currentTurn;
     bool gameInProgress;
     bool isSetupBoard;  // True if current board came from setup mode
     int whiteScore;
     int blackScore;
+    GameClock clock;
+    int searchThreads;  // Threads each engine move is searched on
+    std::unique_ptr<Board> ponderBoard;  // Position the pondering engine searches, after the reply it expects
+    Player* ponderer = nullptr;          // That engine
     void initializePlayers(const std::string& whitePlayer, const std::string& blackPlayer);
     void resetGame();
     void updateScore(Colour winner);
     void announceCurrentPlayer();
+    bool chargeClock();  // Ends the current turn on the clock; false (and the game is lost) if time ran out
 
 public:
     // Constructor and destructor
@@ -34,10 +49,28 @@ public:
     ~Game();
 
     // Core game management methods
-    void startGame(const std::string& whitePlayer, const std::string& blackPlayer); // Takes in human or Computer[1-4]. 
-    void resign();
+    void startGame(const std::string& whitePlayer, const std::string& blackPlayer); // Takes in human or Computer[1-5]. 
+    void resign();               // The side to move resigns
+    void resign(Colour loser);
     void makePlayerMove(const Position& curr, const Position& dest, char promotion);
-    void makeComputerMove();
+    void makeComputerMove();     // thinkComputerMove then playComputerMove
+    // An engine move in two halves, so the thinking can run on a worker thread: thinkComputerMove
+    // only reads the game (the player searches a copy of the board), and stop, when given, ends
+    // the search early with the best move so far. Nothing else may change the game until
+    // playComputerMove has been handed the result.
+    Move thinkComputerMove(const std::atomic<bool>* stop = nullptr, SearchProgressCallback progress = nullptr);
+    void playComputerMove(Move move);
+    // Pondering: the engine that just moved searches on its opponent's time, assuming the reply
+    // expected. preparePonder reads the game, so nothing else may be using it; ponderComputerMove
+    // only touches the copy it made and the engine player, so the opponent's move can be played
+    // meanwhile. While ponder is set the search ignores the clock; clearing it (a ponder hit, once
+    // expected has been played) starts the engine's time and the search carries on as its move.
+    void preparePonder(Move expected, const std::atomic<bool>* stop, const std::atomic<bool>* ponder,
+                       SearchProgressCallback progress);
+    Move ponderComputerMove();
+    // Searches the current position on a copy of the board with the engine players' table, eval
+    // cache, evaluator and threads, calling report after every finished depth; nothing is played
+    void analyse(SearchLimits limits, const SearchProgressCallback& report);
     void enterSetupMode(); // shall stop normalc game flow, and allow configuration to happen cleanly. 
     void setupAddPiece(char piece, const Position& pos);
     void setupRemovePiece(const Position& pos); // Removes piece at that position (1, 1) to (8, 8).
@@ -61,6 +94,13 @@ public:
     // Score management
     void setScores(int white, int black);
     
+    // Engine settings
+    void setHashSize(int megabytes);  // Resizes (and clears) the transposition table if the size changes
+    void setEvalCacheSize(int megabytes);  // The same for the eval cache
+    void setNetwork(std::shared_ptr<const NnueNetwork> nnue);  // Clears the eval cache if the evaluator changes
+    void setClock(long long initialMs, long long incrementMs);  // Call before startGame; 0 means untimed
+    void setThreads(int threads) { searchThreads = threads; }
+    
     // Display management
     void addDisplay(ChessDisplay* display);
     void removeDisplay(ChessDisplay* display);
@@ -0,0 +1,37 @@
+#ifndef GAMECLOCK_H
+#define GAMECLOCK_H
+
+#include <chrono>
+#include "colour.h"
+#include "search.h"
+
+// Chess clock with a per-move increment. The side to move's time runs from startTurn()
+// until endTurn(); a disabled clock (the default) never runs out, and engines then get
+// a fixed budget per move.
+class GameClock {
+    bool enabled;
+    long long remainingMs[2];
+    long long incrementMs;
+    std::chrono::steady_clock::time_point turnStart;
+
+public:
+    GameClock();
+
+    void configure(long long initialMs, long long incrementMs);  // initialMs of 0 disables the clock
+    bool isEnabled() const { return enabled; }
+
+    void startTurn();
+    bool endTurn(Colour colour);  // Charges the time used and adds the increment; false if the flag fell
+
+    long long getRemainingMs(Colour colour) const;
+    long long getIncrementMs() const { return incrementMs; }
+
+    // Per-move budget for an engine: soft limit for starting a new iteration, hard limit to stop
+    SearchLimits limitsFor(Colour colour) const;
+};
+
+// The budget limitsFor gives with remainingMs left on the clock. movesToGo is the number of moves
+// until the next time control; 0 means the rest of the game is played on this time.
+SearchLimits budgetFor(long long remainingMs, long long incrementMs, int movesToGo = 0);
+
+#endif // GAMECLOCK_H
@@ -0,0 +1,50 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+#include "bitboard.h"
+
+// A move packed into 16 bits: from square (6) | to square (6) | promotion piece (2) | kind (2),
+// with squares numbered a1 = 0 ... h8 = 63. The kind tells the board how to play the move, so
+// castling and en passant never have to be worked out again once a move is generated.
+// Move() is the null move; it is never legal (a1 to a1), so it also means "no move".
+class Move {
+public:
+    enum Kind : uint16_t { NORMAL, PROMOTION, EN_PASSANT, CASTLING };
+
+    Move() : data(0) {}
+    Move(int from, int to, Kind kind = NORMAL, PieceType promotion = PieceType::KNIGHT)
+        : data(static_cast<uint16_t>(from | to << 6
+                                     | (static_cast<int>(promotion) - static_cast<int>(PieceType::KNIGHT)) << 12
+                                     | kind << 14)) {}
+
+    static Move fromRaw(uint16_t raw) { Move move; move.data = raw; return move; }
+
+    int from() const { return data & 63; }
+    int to() const { return (data >> 6) & 63; }
+    Kind kind() const { return static_cast<Kind>(data >> 14); }
+    bool isPromotion() const { return kind() == PROMOTION; }
+    PieceType promotion() const { return static_cast<PieceType>(((data >> 12) & 3) + static_cast<int>(PieceType::KNIGHT)); }
+    uint16_t raw() const { return data; }
+    bool isNull() const { return data == 0; }
+
+    bool operator==(Move other) const { return data == other.data; }
+    bool operator!=(Move other) const { return data != other.data; }
+
+    // Coordinate notation ("e2e4", "e7e8Q") for output
+    std::string toString() const {
+        std::string str;
+        str += static_cast<char>('a' + from() % 8);
+        str += static_cast<char>('1' + from() / 8);
+        str += static_cast<char>('a' + to() % 8);
+        str += static_cast<char>('1' + to() / 8);
+        if (isPromotion()) str += "NBRQ"[static_cast<int>(promotion()) - static_cast<int>(PieceType::KNIGHT)];
+        return str;
+    }
+
+private:
+    uint16_t data;
+};
+
+#endif // MOVE_H
@@ -0,0 +1,47 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include <vector>
+#include "move.h"
+
+class Board;
+
+// Hands out the moves of a search node one at a time, best guesses first:
+//   1. the transposition table's move,
+//   2. captures and queen promotions that do not lose material by static exchange evaluation,
+//      most valuable victim first and least valuable attacker breaking ties (pieceWorth values),
+//   3. the two killer moves of this ply (quiet moves that caused a cutoff in a sibling),
+//   4. the remaining quiet moves, by how often each has caused a cutoff (the history table),
+//   5. the captures that lose material.
+// Each stage is only generated when the one before it runs out, so a node that is cut off
+// by the table move or a capture never generates its quiet moves. Moves from the table and
+// the killer slots come from other positions and are checked with Board::isLegal first.
+// Every move returned is legal and none is returned twice.
+class MovePicker {
+public:
+    // Main search: history holds the side to move's cutoff counts by from and to square (may be null)
+    MovePicker(const Board& board, Move tableMove, Move killer1, Move killer2, const int (*history)[64]);
+    // Quiescence search: captures and queen promotions only, leaving out those that lose material
+    explicit MovePicker(const Board& board);
+
+    Move next();  // The null move once every move has been returned
+
+private:
+    enum Stage { TABLE_MOVE, GENERATE_CAPTURES, CAPTURES, KILLERS, GENERATE_QUIETS, QUIETS, BAD_CAPTURES, DONE };
+
+    const Board& board;
+    Stage stage;
+    bool capturesOnly;
+    Move tableMove;
+    Move killers[2];
+    int killerIndex;
+    const int (*history)[64];
+    std::vector<Move> moves;
+    std::vector<int> scores;  // Ordering score of each entry of moves
+    std::vector<Move> badCaptures;
+    size_t current;
+
+    Move pickBest();  // Swaps the best remaining move into place and returns it (selection sort, done lazily)
+};
+
+#endif // MOVEPICKER_H
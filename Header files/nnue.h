@@ -0,0 +1,89 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "move.h"
+
+class Board;
+
+// Efficiently updatable neural network evaluation, an alternative to evaluate() for the engine.
+//
+// Inputs are HalfKP-style: from each side's point of view, one feature per non-king piece on the
+// board, identified by that side's king square, the piece (ours or theirs, and its type) and its
+// square, all seen with that side playing up the board. The first layer turns the active features
+// into HIDDEN int16 values per side (the accumulator). A move changes at most three features, so the
+// accumulator is patched by adding and subtracting a few weight rows instead of being rebuilt; only
+// a move of that side's own king starts it afresh. The output is one linear layer over both
+// accumulators, clipped to 0..127, side to move first.
+//
+// The accumulator and output loops have AVX2 and SSE4.1 versions alongside plain C++; the best one
+// the processor supports is picked the first time a network is made.
+class NnueNetwork {
+public:
+    static const int HIDDEN = 256;                // Accumulator width per side
+    static const int FEATURES = 64 * 10 * 64;     // King square x piece (5 types, ours/theirs) x square
+    static const int OUTPUT_SCALE = 16;           // Output sum / OUTPUT_SCALE = centipawns
+
+    // Loads a network saved by save(); throws std::runtime_error if the file is missing or malformed
+    static std::unique_ptr<NnueNetwork> fromFile(const std::string& path);
+    // The network built into the program, used when no file is given: it is set up from the
+    // piece-square tables (material and placement, halfway between middlegame and endgame)
+    static std::unique_ptr<NnueNetwork> embedded();
+
+    void save(const std::string& path) const;  // Throws std::runtime_error if the file cannot be written
+    const std::string& getSource() const { return source; }  // File name, or "embedded"
+    static const char* kernelName();  // "AVX2", "SSE4.1" or "scalar"
+
+private:
+    friend class NnueAccumulators;
+
+    std::vector<int16_t> featureBiases;   // HIDDEN
+    std::vector<int16_t> featureWeights;  // FEATURES rows of HIDDEN
+    std::vector<int16_t> outputWeights;   // HIDDEN for the side to move, then HIDDEN for the other side
+    int32_t outputBias;
+    std::string source;
+
+    NnueNetwork();
+    const int16_t* row(int feature) const { return &featureWeights[static_cast<size_t>(feature) * HIDDEN]; }
+};
+
+// One search thread's accumulators, a stack with an entry per ply of the line being searched.
+// push() is called before every Board::doMove and pop() after every undoMove; they only note
+// which pieces moved. The accumulator itself is brought up to date when evaluate() needs it,
+// from the nearest entry above that has one, so nodes that are never evaluated cost nothing.
+class NnueAccumulators {
+public:
+    explicit NnueAccumulators(const NnueNetwork& network);
+
+    void reset();                            // The board is a new root: nothing computed yet
+    void push(const Board& board, Move move);  // Before board.doMove(move)
+    void pop() { top--; }                    // After board.undoMove()
+
+    int evaluate(const Board& board);  // Centipawns from the side to move's point of view
+
+private:
+    static const int MAX_DEPTH = 256;  // Board::MAX_STATES: no line gets deeper than the board can undo
+
+    struct Entry {
+        alignas(32) int16_t values[2][NnueNetwork::HIDDEN];  // White's accumulator, then Black's
+        bool computed[2];
+        // Pieces the move into this entry changed: off squares are -1 (captures and promotions)
+        int changes;
+        int8_t piece[3];
+        int8_t from[3];
+        int8_t to[3];
+        bool kingMoved[2];  // A king move forces that side's accumulator to be rebuilt
+    };
+
+    const NnueNetwork& network;
+    std::vector<Entry> entries;
+    int top;
+
+    void refresh(const Board& board, int side, Entry& entry);
+    void update(const Board& board, int side);  // Makes entries[top] current for side
+};
+
+#endif // NNUE_H
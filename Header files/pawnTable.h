@@ -0,0 +1,55 @@
+#ifndef PAWNTABLE_H
+#define PAWNTABLE_H
+
+#include <vector>
+#include <memory>
+#include "bitboard.h"
+#include "zobrist.h"
+
+class Board;
+
+// Small hash table of pawn-structure evaluations, looked up by the board's pawn key.
+// Pawn structure only changes on pawn moves and pawn captures, so nearly every probe in a
+// search hits and the doubled/isolated/backward/passed pawn terms cost almost nothing.
+// Each search thread has a table of its own, so there is no locking.
+class PawnTable {
+public:
+    struct Entry {
+        Key key = 0;          // Pawn key; the all-zero entry is correct for a board with no pawns
+        int mg = 0;           // Pawn-structure score from White's point of view
+        int eg = 0;
+        Bitboard passed = 0;  // Passed pawns of both colours, for evaluate()'s king-distance term
+    };
+
+    static const int DEFAULT_ENTRIES = 8192;  // Must be a power of two
+
+    explicit PawnTable(int entryCount = DEFAULT_ENTRIES);
+
+    const Entry& probe(const Board& board);  // Scores the pawns and stores the result on a miss
+    void clear();
+    void resetCounters() { probes = hits = 0; }
+
+    long long getProbes() const { return probes; }
+    long long getHits() const { return hits; }
+
+private:
+    std::vector<Entry> entries;
+    long long probes;
+    long long hits;
+};
+
+// The pawn tables of one search, a table per thread, kept by whoever keeps the transposition
+// table so their entries carry over from one search to the next
+class PawnTables {
+public:
+    PawnTable& forThread(int thread);  // Thread 0 is the main search thread; made on first use
+    void clear();
+
+private:
+    std::vector<std::unique_ptr<PawnTable>> tables;
+};
+
+// Scores board's pawn structure from scratch into entry (key included)
+void evaluatePawns(const Board& board, PawnTable::Entry& entry);
+
+#endif // PAWNTABLE_H
@@ -0,0 +1,21 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+class Board;
+
+// Move generator checks. perft counts the leaf nodes of the legal move tree to the given
+// depth; the counts for well-known positions are published, so any difference points to a
+// move generation bug. The board is used as scratch space and restored before returning.
+long long perft(Board& board, int depth);
+
+// perft with the node count, time and nodes/sec printed
+void printPerft(Board& board, int depth);
+
+// perft split by root move ("e2e4: 20"), for narrowing down which move a wrong count comes from
+void divide(Board& board, int depth);
+
+// Runs the standard reference positions up to maxDepth, printing nodes, time and nodes/sec
+// for each one. Returns false if any count is wrong.
+bool runPerftSuite(int maxDepth);
+
+#endif // PERFT_H
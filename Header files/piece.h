@@ -5,6 +5,7 @@
 #include "colour.h"
 #include <vector>
 #include <memory>
+#include <string>
 
 // Forward declaration
 class Board;
@@ -19,9 +20,10 @@ public:
     Piece(Colour colour, char symbol);
     virtual ~Piece() = default;
     
-    // Pure virtual methods that must be implemented by subclasses
-    virtual bool isValidMove(const Position& from, const Position& to, const Board& board) const = 0;
-    virtual std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const = 0;
+    // Move rules live on the board, which switches on the piece code of the square;
+    // these just forward to it so older callers keep working
+    bool isValidMove(const Position& from, const Position& to, const Board& board) const;
+    std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const;
     virtual std::unique_ptr<Piece> clone() const = 0;
     
     // Common methods
@@ -37,8 +39,6 @@ public:
 class King : public Piece {
 public:
     King(Colour colour);
-    bool isValidMove(const Position& from, const Position& to, const Board& board) const override;
-    std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const override;
     std::unique_ptr<Piece> clone() const override;
     std::string getType() const override { return "King"; }
 };
@@ -46,8 +46,6 @@ public:
 class Queen : public Piece {
 public:
     Queen(Colour colour);
-    bool isValidMove(const Position& from, const Position& to, const Board& board) const override;
-    std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const override;
     std::unique_ptr<Piece> clone() const override;
     std::string getType() const override { return "Queen"; }
 };
@@ -55,8 +53,6 @@ public:
 class Rook : public Piece {
 public:
     Rook(Colour colour);
-    bool isValidMove(const Position& from, const Position& to, const Board& board) const override;
-    std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const override;
     std::unique_ptr<Piece> clone() const override;
     std::string getType() const override { return "Rook"; }
 };
@@ -64,8 +60,6 @@ public:
 class Bishop : public Piece {
 public:
     Bishop(Colour colour);
-    bool isValidMove(const Position& from, const Position& to, const Board& board) const override;
-    std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const override;
     std::unique_ptr<Piece> clone() const override;
     std::string getType() const override { return "Bishop"; }
 };
@@ -73,8 +67,6 @@ public:
 class Knight : public Piece {
 public:
     Knight(Colour colour);
-    bool isValidMove(const Position& from, const Position& to, const Board& board) const override;
-    std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const override;
     std::unique_ptr<Piece> clone() const override;
     std::string getType() const override { return "Knight"; }
 };
@@ -85,8 +77,6 @@ private:
     
 public:
     Pawn(Colour colour);
-    bool isValidMove(const Position& from, const Position& to, const Board& board) const override;
-    std::vector<Position> getPossibleMoves(const Position& from, const Board& board) const override;
     std::unique_ptr<Piece> clone() const override;
     std::string getType() const override { return "Pawn"; }
     
@@ -0,0 +1,27 @@
+#ifndef PIECESQUARETABLES_H
+#define PIECESQUARETABLES_H
+
+#include "bitboard.h"
+
+// Centipawn piece values, indexed by PieceType (middlegame values; also used for exchanges)
+extern const int pieceValues[6];
+
+// Material plus piece-square bonus for every piece index and square, once for the middlegame
+// and once for the endgame. Entries are from White's point of view, so Black's are negative
+// and a position's score is just the sum over its pieces. The board keeps both sums up to
+// date as pieces come and go.
+struct PieceSquareTables {
+    int mg[12][64];
+    int eg[12][64];
+};
+
+extern PieceSquareTables pieceSquare;
+
+// How far from the endgame a position is: each piece left adds its weight, and the
+// starting position (or anything with more material) counts as MAX_PHASE, a pure middlegame
+const int PHASE_WEIGHT[6] = {0, 1, 1, 2, 4, 0};
+const int MAX_PHASE = 24;
+
+void initPieceSquareTables();  // Fills the tables; safe to call more than once
+
+#endif // PIECESQUARETABLES_H
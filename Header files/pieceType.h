@@ -0,0 +1,11 @@
+#ifndef PIECETYPE_H
+#define PIECETYPE_H
+
+enum class PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+// Rough worth of each piece in pawns, the scale the computer players and capture ordering use.
+// Some consider Knight = 3, others = 2.5; the king is invaluable and never captured in normal play.
+const int PIECE_WORTH[6] = {1, 2, 3, 5, 9, 0};
+inline int pieceWorth(PieceType type) { return PIECE_WORTH[static_cast<int>(type)]; }
+
+#endif // PIECETYPE_H
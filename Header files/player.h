@@ -6,10 +6,17 @@
 #include <vector>
 #include <memory>
 #include "colour.h"
+#include "pieceType.h"
+#include "move.h"
+#include "search.h"
 
 // Forward declarations
 class Board;
 class Position;
+class TranspositionTable;
+class EvalCache;
+class PawnTables;
+class NnueNetwork;
 
 class Player {
 protected:
@@ -21,7 +28,14 @@ public:
     virtual ~Player() = default;
     
     // Pure virtual method for making moves
-    virtual std::string getMove(const Board& board) = 0;
+    virtual Move getMove(const Board& board) = 0;
+    
+    // Time budget for the next getMove; only engine players use it
+    virtual void setSearchLimits(const SearchLimits& limits) { (void)limits; }
+    // Evaluator for the next getMove: a network, or null for the hand-written evaluation
+    virtual void setNetwork(const NnueNetwork* network) { (void)network; }
+    // Called with the search's progress during the next getMove, possibly from the thread running it
+    virtual void setProgressCallback(SearchProgressCallback callback) { (void)callback; }
     
     // Getters
     Colour getColour() const { return colour; }
@@ -31,13 +45,12 @@ public:
 
 protected:
     // Helper method for AI players to get all legal moves
-    std::vector<std::string> getAllLegalMoves(const Board& board) const;
-    std::string positionToString(const Position& pos) const;
+    std::vector<Move> getAllLegalMoves(const Board& board) const;
     
     // Helper methods for AI decision making
-    bool putsEnemyInCheck(const std::string& move, const Board& board) const;
-    bool avoidsCapture(const std::string& move, const Board& board) const;
-    int getPieceValue(const std::string& pieceType) const;
+    bool putsEnemyInCheck(Move move, const Board& board) const;
+    bool avoidsCapture(Move move, const Board& board) const;
+    int getPieceValue(PieceType type) const;
 };
 
 // Subclasses
@@ -46,14 +59,14 @@ class HumanPlayer : public Player {
     
 public:
     HumanPlayer(Colour colour);
-    std::string getMove(const Board& board) override;
+    Move getMove(const Board& board) override;
     std::string getType() const override { return "Human"; }
 };
 
 class ComputerPlayer1 : public Player {
 public:
     ComputerPlayer1(Colour colour);
-    std::string getMove(const Board& board) override;
+    Move getMove(const Board& board) override;
     std::string getType() const override { return "Computer Level 1"; }
     int getLevel() const { return 1; }
 };
@@ -61,7 +74,7 @@ public:
 class ComputerPlayer2 : public Player {
 public:
     ComputerPlayer2(Colour colour);
-    std::string getMove(const Board& board) override;
+    Move getMove(const Board& board) override;
     std::string getType() const override { return "Computer Level 2"; }
     int getLevel() const { return 2; }
 };
@@ -69,7 +82,7 @@ public:
 class ComputerPlayer3 : public Player {
 public:
     ComputerPlayer3(Colour colour);
-    std::string getMove(const Board& board) override;
+    Move getMove(const Board& board) override;
     std::string getType() const override { return "Computer Level 3"; }
     int getLevel() const { return 3; }
 };
@@ -77,11 +90,29 @@ public:
 class ComputerPlayer4 : public Player {
 public:
     ComputerPlayer4(Colour colour);
-    std::string getMove(const Board& board) override;
+    Move getMove(const Board& board) override;
     std::string getType() const override { return "Computer Level 4"; }
     int getLevel() const { return 4; }
 };
 
+class ComputerPlayer5 : public Player {
+    TranspositionTable* table;  // Owned by the Game, shared with the other engine player; may be null
+    EvalCache* evalCache;       // Likewise
+    PawnTables* pawnTables;     // Likewise
+    SearchLimits limits;        // Set by the Game before each move
+    const NnueNetwork* network; // Likewise
+    SearchProgressCallback progressCallback;  // Likewise; may be empty
+    
+public:
+    ComputerPlayer5(Colour colour, TranspositionTable* table, EvalCache* evalCache = nullptr, PawnTables* pawnTables = nullptr);
+    Move getMove(const Board& board) override;
+    void setSearchLimits(const SearchLimits& searchLimits) override { limits = searchLimits; }
+    void setNetwork(const NnueNetwork* nnue) override { network = nnue; }
+    void setProgressCallback(SearchProgressCallback callback) override { progressCallback = std::move(callback); }
+    std::string getType() const override { return "Computer Level 5"; }
+    int getLevel() const { return 5; }
+};
+
 #endif // PLAYER_H
 
 
@@ -2,9 +2,17 @@
 #include <memory>
 #include "player.h"
 
+class TranspositionTable;
+class EvalCache;
+class PawnTables;
+
 class PlayerFactory {
 public:
-    static std::unique_ptr<Player> createPlayer(const std::string& playerType, Colour colour);
+    // table, evalCache and pawnTables are handed to engine players so they share search results
+    // and evaluations for the whole game
+    static std::unique_ptr<Player> createPlayer(const std::string& playerType, Colour colour,
+                                                TranspositionTable* table = nullptr, EvalCache* evalCache = nullptr,
+                                                PawnTables* pawnTables = nullptr);
     
 private:
     static int extractComputerLevel(const std::string& playerType);
@@ -0,0 +1,144 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include "move.h"
+#include "transpositionTable.h"
+#include "pawnTable.h"
+#include "evalCache.h"
+#include "nnue.h"
+
+class Board;
+
+const int MATE_SCORE = 30000;      // Mate at the root; mate in n plies scores MATE_SCORE - n
+const int INFINITE_SCORE = 32000;
+const int MAX_SEARCH_THREADS = 128;
+const int MAX_PLY = 128;           // No line is searched deeper than this, quiescence included
+
+// How long a search may run, and on how many threads. Times are in milliseconds; 0 means no limit.
+struct SearchLimits {
+    int maxDepth = 64;
+    long long softMs = 0;  // No new iteration is started after this much time
+    long long hardMs = 0;  // The running iteration is abandoned at this point
+    long long maxNodes = 0;  // Likewise once the main thread has searched this many nodes
+    int threads = 1;       // Lazy SMP: threads - 1 helpers search alongside the calling thread
+    int multiPV = 1;       // Root moves given an exact score and line each iteration (analysis)
+    const std::atomic<bool>* stopSignal = nullptr;  // Set by another thread to end the search early, like hardMs
+    const std::atomic<bool>* ponder = nullptr;      // While set, the time limits wait: they count from when it is cleared
+};
+
+// One of the best lines found: a root move, its score and the replies expected after it
+struct PrincipalVariation {
+    int score = 0;            // From the side to move's point of view
+    std::vector<Move> moves;  // Root move first; the rest is read back from the transposition table
+};
+
+// Sent by the main search thread each time an iteration finishes
+struct SearchProgress {
+    int depth = 0;
+    long long nodes = 0;      // Main thread's nodes so far
+    long long elapsedMs = 0;
+    std::vector<PrincipalVariation> lines;  // Best first, up to SearchLimits::multiPV of them
+};
+typedef std::function<void(const SearchProgress&)> SearchProgressCallback;
+
+// Alpha-beta search in negamax form: every score is from the point of view of the side
+// to move, so a child's score is simply negated.
+// The search deepens one ply at a time until the limits run out and answers with the best
+// move of the last iteration that finished. Results are cached in the transposition table
+// (when one is given) and its best move is searched first when the position comes up again,
+// which is what makes re-searching the shallower depths cheap. Moves come from a MovePicker:
+// table move, captures, killers, then quiet moves by history.
+// With multiPV above 1, each iteration searches the root once per line, every time leaving out
+// the moves already placed, so the lines after the first get exact scores too; they share the
+// table, killers and history with the first instead of being separate searches.
+// Leaves are not scored while pieces are still hanging: a quiescence search keeps playing
+// captures and promotions (all moves when in check) until the position is quiet, leaving
+// out captures that lose material by static exchange evaluation. Quiet positions are scored by
+// evaluate(), or by an NNUE network when one is given, whose accumulators follow every move made.
+//
+// With more than one thread the search is Lazy SMP: helper threads run the same iterative
+// deepening on their own copy of the board, with their own Search object (and so their own
+// counters, move lists and pawn table), and cooperate only through the shared transposition table.
+// Pawn tables given to the search are handed out one per thread, so they are never shared either.
+// Nothing else is shared apart from the stop flag, so no Board is ever touched by two threads.
+class Search {
+    TranspositionTable* table;  // Not owned; may be null
+    EvalCache* evalCache;       // Not owned, shared by the threads like table; may be null
+    const NnueNetwork* network; // Not owned; null means the hand-written evaluate()
+    std::unique_ptr<NnueAccumulators> accumulators;  // Per thread, only with a network
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point startTime;    // For the reported time and speed
+    std::chrono::steady_clock::time_point budgetStart;  // The time limits count from here: startTime, or the ponder hit
+    std::atomic<bool> stopRequested;  // Owned by the thread that called findBestMove
+    const std::atomic<bool>* stop;    // stopRequested of that thread, polled by every thread of the search
+    bool isMainThread;          // Only the main thread watches the clock
+    long long nodes;
+    long long tableProbes;
+    long long tableHits;
+    PawnTables* pawnTables;     // Not owned; may be null, and then each search makes its own
+    std::unique_ptr<PawnTable> ownPawnTable;  // Used when there are no pawnTables
+    PawnTable* pawnTable;       // This thread's, so never shared
+    long long pawnProbes;   // Summed over all threads once the search is over
+    long long pawnHits;
+    long long evalProbes;
+    long long evalHits;
+    long long evaluations;  // Static evaluations actually computed (eval cache misses)
+    long long elapsedMs;
+    int completedDepth;
+    int bestScore;
+    Move bestMove;
+    std::vector<PrincipalVariation> lines;  // Of the last finished iteration (main thread)
+    SearchProgressCallback progressCallback;
+    Move killers[MAX_PLY][2];  // Last two quiet moves that caused a cutoff at each ply
+    int history[2][64][64];    // Cutoffs caused by each quiet move, per side, by from and to square
+
+    static const long long NODES_BETWEEN_TIME_CHECKS = 2048;
+    static const int HISTORY_LIMIT = 1 << 20;
+
+    void reset(const SearchLimits& searchLimits);
+    void usePawnTable(int thread);  // Picks this thread's pawn table and zeroes its counters
+    void iterate(Board& board, std::vector<Move> rootMoves, int startDepth);  // Iterative deepening loop of one thread
+    int negamax(Board& board, int depth, int alpha, int beta, int ply);
+    int quiesce(Board& board, int alpha, int beta, int ply);
+    int staticEval(const Board& board);  // evaluate() or the network, through the eval cache
+    void playMove(Board& board, Move move);  // doMove, keeping the network's accumulators in step
+    void takeBack(Board& board);
+    void rememberCutoff(Colour us, Move move, int depthLeft, int ply);  // Killer and history update for a quiet cutoff move
+    int searchRoot(Board& board, std::vector<Move>& rootMoves, int depth, size_t first);  // Moves the best of rootMoves[first..] to first
+    std::vector<Move> principalVariation(Board& board, Move rootMove, int maxLength) const;  // Follows the table's moves
+    bool probeTable(Key key, TranspositionTable::Entry& entry);
+    bool stopped() const { return stop->load(std::memory_order_relaxed); }
+    long long elapsed() const;
+    long long budgetElapsed() const;  // Time charged against softMs and hardMs
+    bool pondering();  // On the first call after a ponder hit, restarts the clock
+    void checkTime();
+
+public:
+    explicit Search(TranspositionTable* table, EvalCache* evalCache = nullptr, const NnueNetwork* network = nullptr,
+                    PawnTables* pawnTables = nullptr);
+
+    // Searches the side to move on board and returns the best move (the null move if there is none).
+    // The board is used as scratch space by the calling thread and is restored before returning;
+    // helper threads search copies of it.
+    Move findBestMove(Board& board, const SearchLimits& limits);
+    void setProgressCallback(SearchProgressCallback callback) { progressCallback = std::move(callback); }
+
+    long long getNodes() const { return nodes; }  // Summed over all threads
+    long long getElapsedMs() const { return elapsedMs; }
+    long long getNodesPerSecond() const;
+    int getCompletedDepth() const { return completedDepth; }
+    int getBestScore() const { return bestScore; }
+    const std::vector<PrincipalVariation>& getLines() const { return lines; }  // Lines of the main thread's last iteration
+    double getTableHitRate() const;  // Percentage of table probes that found their position
+    double getPawnTableHitRate() const;  // The same for the pawn-structure table
+    double getEvalCacheHitRate() const;  // And for the eval cache
+    long long getEvaluationsPerSecond() const;
+};
+
+#endif // SEARCH_H
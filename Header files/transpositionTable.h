@@ -0,0 +1,57 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "zobrist.h"
+
+// Fixed-size hash table of search results, shared by the engine players of a Game and by
+// every thread of a search.
+// Entries are packed into 8 bytes and grouped 8 to a 64-byte bucket, so a probe touches
+// exactly one cache line. The bucket count is a power of two and is picked from the low
+// bits of the key; the top 16 bits of the key are kept in the entry to verify a match.
+// Each entry is read and written as one relaxed 64-bit atomic, so no locks are needed: the
+// key check travels with the data and a reader never sees half of two different entries.
+// Two threads storing into the same bucket at once can lose one result, which only costs
+// a re-search.
+class TranspositionTable {
+public:
+    enum Bound : uint8_t { BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT };
+
+    struct Entry {
+        uint16_t move;   // Best (or refutation) move as Move::raw(), 0 if none
+        int score;
+        int depth;
+        Bound bound;
+    };
+
+    explicit TranspositionTable(int megabytes = 16);
+
+    void resize(int megabytes);  // Also clears the table
+    void clear();
+    void newSearch();            // Ages existing entries so they are replaced first
+
+    // Safe to call from several threads at once; hit statistics are kept by the caller
+    // (see Search) so threads do not fight over shared counters
+    bool probe(Key key, Entry& entry) const;
+    void store(Key key, int depth, Bound bound, int score, uint16_t move);
+
+    int getSizeMB() const { return sizeMB; }
+
+private:
+    static const int ENTRIES_PER_BUCKET = 8;
+
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> entries[ENTRIES_PER_BUCKET];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    uint64_t bucketMask;
+    int sizeMB;
+    uint8_t generation;  // 6 bits, bumped by newSearch before the search threads start
+
+    Bucket& bucketFor(Key key) const { return buckets[key & bucketMask]; }
+};
+
+#endif // TRANSPOSITIONTABLE_H
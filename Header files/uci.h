@@ -0,0 +1,64 @@
+#ifndef UCI_H
+#define UCI_H
+
+#include <string>
+#include <sstream>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "board.h"
+#include "search.h"
+#include "transpositionTable.h"
+#include "evalCache.h"
+#include "pawnTable.h"
+#include "nnue.h"
+
+// Universal Chess Interface front-end, used instead of CommandInterpreter when the program is
+// started with --uci, so GUIs and match managers can drive the engine. Standard output carries
+// protocol lines only: one 'info' line per principal variation when a depth finishes, and
+// 'bestmove' when the search ends. Problems are reported as 'info string'.
+//
+// Commands: uci, isready, ucinewgame, setoption, position (startpos or fen, then moves),
+// go (depth, movetime, nodes, wtime/btime/winc/binc/movestogo, infinite, ponder), stop,
+// ponderhit and quit.
+//
+// The search runs on searchThread, on its own copy of the board, while input is still read.
+// stop, ponderhit, isready and quit are answered straight away; every other command waits for
+// the search to end first, so the position, tables and network are never changed under it.
+class UciEngine {
+    std::unique_ptr<Board> board;  // Set by the last position command
+    TranspositionTable table;
+    EvalCache evalCache;
+    PawnTables pawnTables;
+    std::shared_ptr<const NnueNetwork> network;  // Null for the hand-written evaluation
+    bool useNnue = false;
+    std::string evalFile = "embedded";  // Network loaded when useNnue is set
+    int threads = 1;
+    int multiPV = 1;
+
+    std::thread searchThread;
+    std::atomic<bool> stopSearch{false};
+    std::atomic<bool> pondering{false};  // go ponder until ponderhit; the time limits wait meanwhile
+    std::mutex outputMutex;              // Lines from the search thread and the input thread never mix
+
+    static const int DEFAULT_HASH_MB = 16;
+    static const int DEFAULT_EVAL_CACHE_MB = 4;
+
+public:
+    UciEngine();
+    ~UciEngine();
+    void run();
+
+private:
+    bool handleCommand(const std::string& command);  // false on quit
+    void setPosition(std::istringstream& in);
+    void setOption(std::istringstream& in);
+    void startSearch(std::istringstream& in);
+    void think(Board& root, SearchLimits limits, bool infinite);  // Search thread
+    void loadNetwork();
+    void waitForSearch();
+    void send(const std::string& line);
+};
+
+#endif // UCI_H
@@ -0,0 +1,22 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+// Zobrist hashing: every (piece, square), castling-rights combination, en passant file
+// and the side to move gets a random 64-bit number. A position's key is the XOR of the
+// numbers for everything true in it, so a move updates the key with a few XORs.
+typedef uint64_t Key;
+
+struct ZobristKeys {
+    Key pieceSquare[12][64];  // Indexed by piece index and square
+    Key castling[16];         // Indexed by the castling rights bit mask
+    Key enPassant[8];         // Indexed by file
+    Key blackToMove;
+};
+
+extern ZobristKeys zobrist;
+
+void initZobrist();  // Fills the tables; safe to call more than once
+
+#endif // ZOBRIST_H
@@ -0,0 +1,191 @@
+#include "attacks.h"
+#include <vector>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_PEXT_SUPPORT 1
+#endif
+
+Magic rookMagics[64];
+Magic bishopMagics[64];
+bool usePext = false;
+Bitboard knightAttackTable[64];
+Bitboard kingAttackTable[64];
+Bitboard pawnAttackTable[2][64];
+Bitboard betweenTable[64][64];
+Bitboard lineTable[64][64];
+
+namespace {
+std::vector<Bitboard> rookTable(0x19000);   // 102400 entries across all squares
+std::vector<Bitboard> bishopTable(0x1480);  // 5248 entries across all squares
+
+const int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+const int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// Reference ray walk, the same way the pieces used to check their paths:
+// step square by square and stop at (and include) the first blocker.
+Bitboard slidingAttacksByRayWalk(int square, Bitboard occupied, const int directions[4][2]) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; d++) {
+        int row = square / 8 + directions[d][0];
+        int col = square % 8 + directions[d][1];
+        while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+            Bitboard bb = squareBB(row * 8 + col);
+            attacks |= bb;
+            if (occupied & bb) break;
+            row += directions[d][0];
+            col += directions[d][1];
+        }
+    }
+    return attacks;
+}
+
+// Small xorshift generator, fixed seeds so the magics found are the same every run
+class MagicRandom {
+    uint64_t state;
+public:
+    explicit MagicRandom(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+    uint64_t sparse() { return next() & next() & next(); }  // Few bits set makes good magic candidates
+};
+
+void buildTable(Magic magics[64], std::vector<Bitboard>& table, const int directions[4][2]) {
+    const uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+    Bitboard occupancy[4096], reference[4096];
+    int epoch[4096] = {0};
+    int attempt = 0;
+    Bitboard* next = table.data();
+
+    for (int square = 0; square < 64; square++) {
+        // Edges only matter if they are not the edge the ray is travelling along
+        Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * (square / 8)))) |
+                         ((FILE_A | FILE_H) & ~(FILE_A << (square % 8)));
+        Magic& m = magics[square];
+        m.mask = slidingAttacksByRayWalk(square, 0, directions) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = next;
+
+        // Enumerate every subset of the mask (carry-rippler trick)
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancy[size] = subset;
+            reference[size] = slidingAttacksByRayWalk(square, subset, directions);
+#ifdef HAS_PEXT_SUPPORT
+            if (usePext) m.attacks[pextIndex(subset, m.mask)] = reference[size];
+#endif
+            size++;
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+        next += size;
+
+        if (usePext) continue;
+
+        // Try random sparse numbers until one maps every occupancy without a harmful collision
+        MagicRandom rng(seeds[square / 8]);
+        for (int i = 0; i < size;) {
+            for (m.magic = 0; popCount((m.mask * m.magic) >> 56) < 6;) {
+                m.magic = rng.sparse();
+            }
+            attempt++;
+            for (i = 0; i < size; i++) {
+                unsigned idx = m.index(occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Squares reached by single steps from square, dropping any that fall off the board
+Bitboard stepAttacks(int square, const int steps[][2], int count) {
+    Bitboard attacks = 0;
+    for (int i = 0; i < count; i++) {
+        int row = square / 8 + steps[i][0];
+        int col = square % 8 + steps[i][1];
+        if (row >= 0 && row < 8 && col >= 0 && col < 8) attacks |= squareBB(row * 8 + col);
+    }
+    return attacks;
+}
+
+void buildLeaperTables() {
+    const int knightSteps[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+    const int kingSteps[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+    const int whitePawnSteps[2][2] = {{1, -1}, {1, 1}};
+    const int blackPawnSteps[2][2] = {{-1, -1}, {-1, 1}};
+    for (int square = 0; square < 64; square++) {
+        knightAttackTable[square] = stepAttacks(square, knightSteps, 8);
+        kingAttackTable[square] = stepAttacks(square, kingSteps, 8);
+        pawnAttackTable[0][square] = stepAttacks(square, whitePawnSteps, 2);
+        pawnAttackTable[1][square] = stepAttacks(square, blackPawnSteps, 2);
+    }
+}
+
+// Needs the sliding tables: a line is what a bishop or rook sees from each end on an empty board
+void buildLineTables() {
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            betweenTable[a][b] = lineTable[a][b] = 0;
+            if (a == b) continue;
+            if (bishopAttacks(a, 0) & squareBB(b)) {
+                lineTable[a][b] = (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | squareBB(a) | squareBB(b);
+                betweenTable[a][b] = bishopAttacks(a, squareBB(b)) & bishopAttacks(b, squareBB(a));
+            } else if (rookAttacks(a, 0) & squareBB(b)) {
+                lineTable[a][b] = (rookAttacks(a, 0) & rookAttacks(b, 0)) | squareBB(a) | squareBB(b);
+                betweenTable[a][b] = rookAttacks(a, squareBB(b)) & rookAttacks(b, squareBB(a));
+            }
+        }
+    }
+}
+
+bool buildAttackTables() {
+    buildLeaperTables();
+#ifdef HAS_PEXT_SUPPORT
+    usePext = __builtin_cpu_supports("bmi2");
+#endif
+    buildTable(rookMagics, rookTable, rookDirections);
+    buildTable(bishopMagics, bishopTable, bishopDirections);
+    buildLineTables();
+    assert(verifySlidingAttacks());
+    return true;
+}
+}
+
+#ifdef HAS_PEXT_SUPPORT
+__attribute__((target("bmi2")))
+unsigned pextIndex(Bitboard occupied, Bitboard mask) {
+    return static_cast<unsigned>(_pext_u64(occupied, mask));
+}
+#else
+unsigned pextIndex(Bitboard occupied, Bitboard mask) {
+    (void)occupied; (void)mask;
+    return 0;  // usePext is never set without BMI2
+}
+#endif
+
+void initAttacks() {
+    static const bool built = buildAttackTables();  // Thread-safe, runs exactly once
+    (void)built;
+}
+
+bool verifySlidingAttacks() {
+    MagicRandom rng(0x9E3779B97F4A7C15ULL);
+    for (int square = 0; square < 64; square++) {
+        for (int i = 0; i < 256; i++) {
+            Bitboard occupied = rng.next() & rng.next();  // Roughly a quarter of the squares filled
+            if (rookAttacks(square, occupied) != slidingAttacksByRayWalk(square, occupied, rookDirections)) return false;
+            if (bishopAttacks(square, occupied) != slidingAttacksByRayWalk(square, occupied, bishopDirections)) return false;
+        }
+    }
+    return true;
+}
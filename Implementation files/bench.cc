@@ -0,0 +1,72 @@
+#include "bench.h"
+#include "board.h"
+#include "search.h"
+#include "transpositionTable.h"
+#include "evalCache.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+namespace {
+// Opening, middlegame and endgame positions with plenty of tactics
+const char* const benchPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1QBPPP/R3KB1R w KQ - 0 9",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "2rq1rk1/pb2bppp/1pn1pn2/2pp4/3P4/1PNBPN2/PB3PPP/2RQ1RK1 w - - 0 11",
+    "r2q1rk1/ppp2ppp/2n1bn2/2b1p3/3pP3/3P1NPP/PPP1NPB1/R1BQ1RK1 b - - 0 9",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+};
+
+struct BenchResult {
+    long long ms = 0;
+    long long nodes = 0;
+};
+
+BenchResult benchThreads(int threads, int depth, TranspositionTable& table, EvalCache& evalCache) {
+    BenchResult result;
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    limits.threads = threads;
+    
+    for (const char* fen : benchPositions) {
+        Board board;
+        board.setFen(fen);
+        table.clear();
+        evalCache.clear();
+        Search search(&table, &evalCache);
+        search.findBestMove(board, limits);
+        result.ms += search.getElapsedMs();
+        result.nodes += search.getNodes();
+    }
+    return result;
+}
+}
+
+void runBench(int maxThreads, int depth, int hashMB, int evalCacheMB) {
+    TranspositionTable table(hashMB);
+    EvalCache evalCache(evalCacheMB);
+    int positions = sizeof(benchPositions) / sizeof(benchPositions[0]);
+    std::cout << "Benchmark: " << positions << " positions to depth " << depth << ", "
+              << hashMB << " MB transposition table, " << evalCacheMB << " MB eval cache" << std::endl;
+    std::cout << std::setw(8) << "Threads" << std::setw(12) << "Time (ms)" << std::setw(14) << "Nodes"
+              << std::setw(14) << "Nodes/sec" << std::setw(10) << "Speedup" << std::endl;
+    
+    // 1, 2, 4, ... and maxThreads itself
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+    
+    long long singleThreadMs = 0;
+    for (int threads : threadCounts) {
+        BenchResult result = benchThreads(threads, depth, table, evalCache);
+        if (threads == 1) singleThreadMs = result.ms;
+        long long nps = result.ms > 0 ? result.nodes * 1000 / result.ms : result.nodes * 1000;
+        double speedup = result.ms > 0 ? static_cast<double>(singleThreadMs) / result.ms : 0.0;
+        std::cout << std::setw(8) << threads << std::setw(12) << result.ms << std::setw(14) << result.nodes
+                  << std::setw(14) << nps << std::setw(9) << std::fixed << std::setprecision(2) << speedup
+                  << std::defaultfloat << "x" << std::endl;
+    }
+}
@@ -1,22 +1,202 @@
 #include "board.h"
 #include "piece.h"
 #include "display.h"
+#include "attacks.h"
 #include <iostream>
 #include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+// getPiece hands out one shared Piece object per colour/type, so callers that still
+// think in terms of Piece* keep working on top of the bitboards.
+Piece* pieceFacade(int index) {
+    static King whiteKing(Colour::WHITE), blackKing(Colour::BLACK);
+    static Queen whiteQueen(Colour::WHITE), blackQueen(Colour::BLACK);
+    static Rook whiteRook(Colour::WHITE), blackRook(Colour::BLACK);
+    static Bishop whiteBishop(Colour::WHITE), blackBishop(Colour::BLACK);
+    static Knight whiteKnight(Colour::WHITE), blackKnight(Colour::BLACK);
+    static Pawn whitePawn(Colour::WHITE), blackPawn(Colour::BLACK);
+    static Piece* const facades[12] = {
+        &whitePawn, &whiteKnight, &whiteBishop, &whiteRook, &whiteQueen, &whiteKing,
+        &blackPawn, &blackKnight, &blackBishop, &blackRook, &blackQueen, &blackKing
+    };
+    return facades[index];
+}
+
+// Piece index for a setup character such as 'K' or 'p', NO_PIECE if unknown
+int indexFromChar(char pieceChar) {
+    Colour colour = (pieceChar >= 'A' && pieceChar <= 'Z') ? Colour::WHITE : Colour::BLACK;
+    switch (tolower(pieceChar)) {
+        case 'k': return pieceIndex(colour, PieceType::KING);
+        case 'q': return pieceIndex(colour, PieceType::QUEEN);
+        case 'r': return pieceIndex(colour, PieceType::ROOK);
+        case 'b': return pieceIndex(colour, PieceType::BISHOP);
+        case 'n': return pieceIndex(colour, PieceType::KNIGHT);
+        case 'p': return pieceIndex(colour, PieceType::PAWN);
+    }
+    return NO_PIECE;
+}
+
+PieceType promotionType(char promotion) {  // A queen unless something else was asked for
+    switch (promotion) {
+        case 'R': case 'r': return PieceType::ROOK;
+        case 'B': case 'b': return PieceType::BISHOP;
+        case 'N': case 'n': return PieceType::KNIGHT;
+    }
+    return PieceType::QUEEN;
+}
+
+// Is square attacked by any of byColour's pieces in the given piece sets
+bool attackedBy(const Bitboard pieceBB[12], Bitboard occupied, int square, Colour byColour) {
+    Colour defender = (byColour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    const Bitboard* theirs = pieceBB + colourIndex(byColour) * 6;
+    Bitboard queens = theirs[static_cast<int>(PieceType::QUEEN)];
+    // A pawn of the defender's colour on square would capture exactly where the attacking pawns stand
+    return (pawnAttacks(defender, square) & theirs[static_cast<int>(PieceType::PAWN)])
+        || (knightAttacks(square) & theirs[static_cast<int>(PieceType::KNIGHT)])
+        || (kingAttacks(square) & theirs[static_cast<int>(PieceType::KING)])
+        || (bishopAttacks(square, occupied) & (theirs[static_cast<int>(PieceType::BISHOP)] | queens))
+        || (rookAttacks(square, occupied) & (theirs[static_cast<int>(PieceType::ROOK)] | queens));
+}
+}
 
 Board::Board() : lastMoveFrom(0, 0), lastMoveTo(0, 0),
                  whiteKingMoved(false), blackKingMoved(false),
                  whiteRookKingMoved(false), whiteRookQueenMoved(false),
-                 blackRookKingMoved(false), blackRookQueenMoved(false) {
-    // Initialize 8x8 board with nullptr
-    grid.resize(8);
-    for (int i = 0; i < 8; i++) {
-        grid[i].resize(8);
-    }
+                 blackRookKingMoved(false), blackRookQueenMoved(false),
+                 sideToMove(Colour::WHITE), key(0), pawnKey(0), mgScore(0), egScore(0), phase(0), stateCount(0) {
+    initAttacks();  // No-op after the first board
+    initZobrist();
+    initPieceSquareTables();
+    clear();  // Start with every bitboard empty
+}
+
+Board::Board(const Board& other)
+    : occupiedBB(other.occupiedBB),
+      lastMoveFrom(other.lastMoveFrom), lastMoveTo(other.lastMoveTo),
+      whiteKingMoved(other.whiteKingMoved), blackKingMoved(other.blackKingMoved),
+      whiteRookKingMoved(other.whiteRookKingMoved), whiteRookQueenMoved(other.whiteRookQueenMoved),
+      blackRookKingMoved(other.blackRookKingMoved), blackRookQueenMoved(other.blackRookQueenMoved),
+      sideToMove(other.sideToMove), key(other.key), pawnKey(other.pawnKey),
+      mgScore(other.mgScore), egScore(other.egScore), phase(other.phase), stateCount(other.stateCount) {
+    std::copy(other.pieceBB, other.pieceBB + 12, pieceBB);
+    std::copy(other.colourBB, other.colourBB + 2, colourBB);
+    std::copy(other.mailbox, other.mailbox + 64, mailbox);
+    std::copy(other.states, other.states + stateCount, states);  // Only the live part of the undo stack
+    // observers stay empty: nothing the copy does should redraw the game's displays
 }
 
 Board::~Board() = default;
 
+void Board::putPiece(int index, int square) {
+    Bitboard bb = squareBB(square);
+    pieceBB[index] |= bb;
+    colourBB[index < 6 ? 0 : 1] |= bb;
+    occupiedBB |= bb;
+    mailbox[square] = index;
+    key ^= zobrist.pieceSquare[index][square];
+    if (typeOfIndex(index) == PieceType::PAWN) pawnKey ^= zobrist.pieceSquare[index][square];
+    mgScore += pieceSquare.mg[index][square];
+    egScore += pieceSquare.eg[index][square];
+    phase += PHASE_WEIGHT[index % 6];
+}
+
+void Board::removePieceAt(int square) {
+    int index = mailbox[square];
+    if (index == NO_PIECE) return;
+    Bitboard bb = squareBB(square);
+    pieceBB[index] &= ~bb;
+    colourBB[index < 6 ? 0 : 1] &= ~bb;
+    occupiedBB &= ~bb;
+    mailbox[square] = NO_PIECE;
+    key ^= zobrist.pieceSquare[index][square];
+    if (typeOfIndex(index) == PieceType::PAWN) pawnKey ^= zobrist.pieceSquare[index][square];
+    mgScore -= pieceSquare.mg[index][square];
+    egScore -= pieceSquare.eg[index][square];
+    phase -= PHASE_WEIGHT[index % 6];
+}
+
+void Board::movePiece(int from, int to) {  // 'to' must be empty
+    int index = mailbox[from];
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+    pieceBB[index] ^= fromTo;
+    colourBB[index < 6 ? 0 : 1] ^= fromTo;
+    occupiedBB ^= fromTo;
+    mailbox[to] = index;
+    mailbox[from] = NO_PIECE;
+    key ^= zobrist.pieceSquare[index][from] ^ zobrist.pieceSquare[index][to];
+    if (typeOfIndex(index) == PieceType::PAWN) pawnKey ^= zobrist.pieceSquare[index][from] ^ zobrist.pieceSquare[index][to];
+    mgScore += pieceSquare.mg[index][to] - pieceSquare.mg[index][from];
+    egScore += pieceSquare.eg[index][to] - pieceSquare.eg[index][from];
+}
+
+bool Board::scoresMatch() const {
+    int mg = 0, eg = 0, weight = 0;
+    for (int square = 0; square < 64; square++) {
+        int index = mailbox[square];
+        if (index == NO_PIECE) continue;
+        mg += pieceSquare.mg[index][square];
+        eg += pieceSquare.eg[index][square];
+        weight += PHASE_WEIGHT[index % 6];
+    }
+    return mg == mgScore && eg == egScore && weight == phase;
+}
+
+Key Board::computeKey() const {
+    Key k = 0;
+    for (int square = 0; square < 64; square++) {
+        if (mailbox[square] != NO_PIECE) k ^= zobrist.pieceSquare[mailbox[square]][square];
+    }
+    k ^= zobrist.castling[castlingRights()];
+    int epFile = enPassantFile();
+    if (epFile != -1) k ^= zobrist.enPassant[epFile];
+    if (sideToMove == Colour::BLACK) k ^= zobrist.blackToMove;
+    return k;
+}
+
+Key Board::computePawnKey() const {
+    Key k = 0;
+    for (int index : {pieceIndex(Colour::WHITE, PieceType::PAWN), pieceIndex(Colour::BLACK, PieceType::PAWN)}) {
+        Bitboard pawns = pieceBB[index];
+        while (pawns) k ^= zobrist.pieceSquare[index][popLsb(pawns)];
+    }
+    return k;
+}
+
+void Board::setSideToMove(Colour colour) {
+    if (colour == sideToMove) return;
+    // The en passant file depends on who is to move, so take it out and put it back around the switch
+    int epFile = enPassantFile();
+    if (epFile != -1) key ^= zobrist.enPassant[epFile];
+    sideToMove = colour;
+    key ^= zobrist.blackToMove;
+    epFile = enPassantFile();
+    if (epFile != -1) key ^= zobrist.enPassant[epFile];
+}
+
+int Board::castlingRights() const {
+    int rights = 0;
+    if (!whiteKingMoved && !whiteRookKingMoved) rights |= 1;
+    if (!whiteKingMoved && !whiteRookQueenMoved) rights |= 2;
+    if (!blackKingMoved && !blackRookKingMoved) rights |= 4;
+    if (!blackKingMoved && !blackRookQueenMoved) rights |= 8;
+    return rights;
+}
+
+int Board::enPassantFile() const {
+    // Only counts when the last move was a double pawn push and a pawn of the side to move is beside it,
+    // so positions that differ only by an unusable en passant chance share a key
+    if (!lastMoveTo.isValid() || abs(lastMoveTo.getRow() - lastMoveFrom.getRow()) != 2) return -1;
+    int square = toSquare(lastMoveTo);
+    if (mailbox[square] == NO_PIECE || typeOfIndex(mailbox[square]) != PieceType::PAWN) return -1;
+    if (colourOfIndex(mailbox[square]) == sideToMove) return -1;
+    Bitboard bb = squareBB(square);
+    Bitboard beside = ((bb << 1) & ~FILE_A) | ((bb >> 1) & ~FILE_H);
+    return (beside & pieces(sideToMove, PieceType::PAWN)) ? square % 8 : -1;
+}
+
 void Board::notifyObservers() const {
     for (ChessDisplay* observer : observers) {
         if (observer) {
@@ -29,35 +209,22 @@ void Board::setupStartingPosition() {
     // Clear the board first
     clear();
     
-    // Place white pieces (row 1-2)
-    grid[0][0] = std::make_unique<Rook>(Colour::WHITE);
-    grid[0][1] = std::make_unique<Knight>(Colour::WHITE);
-    grid[0][2] = std::make_unique<Bishop>(Colour::WHITE);
-    grid[0][3] = std::make_unique<Queen>(Colour::WHITE);
-    grid[0][4] = std::make_unique<King>(Colour::WHITE);
-    grid[0][5] = std::make_unique<Bishop>(Colour::WHITE);
-    grid[0][6] = std::make_unique<Knight>(Colour::WHITE);
-    grid[0][7] = std::make_unique<Rook>(Colour::WHITE);
-    
-    // White pawns
-    for (int col = 0; col < 8; col++) {
-        grid[1][col] = std::make_unique<Pawn>(Colour::WHITE);
-    }
-    
-    // Place black pieces (row 7-8)
-    grid[7][0] = std::make_unique<Rook>(Colour::BLACK);
-    grid[7][1] = std::make_unique<Knight>(Colour::BLACK);
-    grid[7][2] = std::make_unique<Bishop>(Colour::BLACK);
-    grid[7][3] = std::make_unique<Queen>(Colour::BLACK);
-    grid[7][4] = std::make_unique<King>(Colour::BLACK);
-    grid[7][5] = std::make_unique<Bishop>(Colour::BLACK);
-    grid[7][6] = std::make_unique<Knight>(Colour::BLACK);
-    grid[7][7] = std::make_unique<Rook>(Colour::BLACK);
+    // Back rank order from a to h
+    const PieceType backRank[8] = {
+        PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
+        PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
+    };
     
-    // Black pawns
     for (int col = 0; col < 8; col++) {
-        grid[6][col] = std::make_unique<Pawn>(Colour::BLACK);
+        // Place white pieces (row 1-2)
+        putPiece(pieceIndex(Colour::WHITE, backRank[col]), col);
+        putPiece(pieceIndex(Colour::WHITE, PieceType::PAWN), 8 + col);
+        
+        // Place black pieces (row 7-8)
+        putPiece(pieceIndex(Colour::BLACK, PieceType::PAWN), 48 + col);
+        putPiece(pieceIndex(Colour::BLACK, backRank[col]), 56 + col);
     }
+    setSideToMove(Colour::WHITE);
     
     // Notify observers of board setup
     notifyObservers();
@@ -66,6 +233,7 @@ void Board::setupStartingPosition() {
 void Board::clearGameHistory() { // Extra, look when needed. 
     lastMoveFrom = Position(0, 0);
     lastMoveTo = Position(0, 0);
+    key = computeKey();  // En passant file may have changed
 }
 
 void Board::resetSpecialRules() {
@@ -75,59 +243,24 @@ void Board::resetSpecialRules() {
     whiteRookQueenMoved = false;
     blackRookKingMoved = false;
     blackRookQueenMoved = false;
-    
-    // Reset en passant flags for all pawns
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (grid[row][col] && grid[row][col]->getType() == "Pawn") {
-                auto* pawn = dynamic_cast<Pawn*>(grid[row][col].get());
-                if (pawn) {
-                    pawn->setCanEnPassant(false);
-                }
-            }
-        }
-    }
+    // En passant is tracked through lastMoveFrom/lastMoveTo, which clearGameHistory resets
+    key = computeKey();  // Castling rights changed
 }
 
 Piece* Board::getPiece(const Position& pos) const {
     if (!pos.isValid()) return nullptr;
-    return grid[pos.getRow() - 1][pos.getCol() - 1].get();  // Convert to 0-indexed
+    int index = mailbox[toSquare(pos)];
+    return index == NO_PIECE ? nullptr : pieceFacade(index);
 }
 
 bool Board::isInCheck(Colour colour) const {
     // Find the king
-    Position kingPos(0, 0);
-    bool kingFound = false;
-    
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (grid[row][col] && grid[row][col]->getType() == "King" && 
-                grid[row][col]->getColour() == colour) {
-                kingPos = Position(row + 1, col + 1);  // Convert to 1-indexed
-                kingFound = true;
-                break;
-            }
-        }
-        if (kingFound) break;
-    }
-    
-    if (!kingFound) return false; // Dumb shii
+    int king = kingSquare(colour);
+    if (king == -1) return false; // Dumb shii
     
     // Check if any enemy piece can attack the king
     Colour enemyColour = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
-    
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (grid[row][col] && grid[row][col]->getColour() == enemyColour) { // Look for each piece of the opposite colour, then check if that piece can legally capture the King, using that Piece's individual overloaded isValid() move. 
-                Position from(row + 1, col + 1);  // Convert to 1-indexed
-                if (grid[row][col]->isValidMove(from, kingPos, *this)) {
-                    return true;
-                }
-            }
-        }
-    }
-    
-    return false;
+    return isSquareAttacked(king, enemyColour);
 }
 
 bool Board::canCastleKingSide(Colour colour) const {
@@ -135,32 +268,29 @@ bool Board::canCastleKingSide(Colour colour) const {
         if (whiteKingMoved || whiteRookKingMoved) return false;
         
         // Check if king and rook are still in their original positions
-        Piece* king = grid[0][4].get();  // e1
-        Piece* rook = grid[0][7].get();  // h1
-        if (!king || king->getType() != "King" || king->getColour() != Colour::WHITE) return false;
-        if (!rook || rook->getType() != "Rook" || rook->getColour() != Colour::WHITE) return false;
+        if (mailbox[4] != pieceIndex(Colour::WHITE, PieceType::KING)) return false;  // e1
+        if (mailbox[7] != pieceIndex(Colour::WHITE, PieceType::ROOK)) return false;  // h1
         
         // Check if path is clear
-        if (grid[0][5] || grid[0][6]) return false;  // f1, g1 must be empty
+        if (occupiedBB & (squareBB(5) | squareBB(6))) return false;  // f1, g1 must be empty
         
-        // King must not be in check, and must not pass through check
+        // King must not be in check, and must not pass through or land on an attacked square
         if (isInCheck(colour)) return false;
-        // TODO: Check if king passes through check at f1
+        if (isSquareAttacked(5, Colour::BLACK) || isSquareAttacked(6, Colour::BLACK)) return false;  // f1, g1
         return true;
     } else {
         if (blackKingMoved || blackRookKingMoved) return false;
         
         // Check if king and rook are still in their original positions
-        Piece* king = grid[7][4].get();  // e8
-        Piece* rook = grid[7][7].get();  // h8
-        if (!king || king->getType() != "King" || king->getColour() != Colour::BLACK) return false;
-        if (!rook || rook->getType() != "Rook" || rook->getColour() != Colour::BLACK) return false;
+        if (mailbox[60] != pieceIndex(Colour::BLACK, PieceType::KING)) return false;  // e8
+        if (mailbox[63] != pieceIndex(Colour::BLACK, PieceType::ROOK)) return false;  // h8
         
         // Check if path is clear
-        if (grid[7][5] || grid[7][6]) return false;  // f8, g8 must be empty
+        if (occupiedBB & (squareBB(61) | squareBB(62))) return false;  // f8, g8 must be empty
         
-        // King must not be in check
+        // King must not be in check, and must not pass through or land on an attacked square
         if (isInCheck(colour)) return false;
+        if (isSquareAttacked(61, Colour::WHITE) || isSquareAttacked(62, Colour::WHITE)) return false;  // f8, g8
         return true;
     }
 }
@@ -170,254 +300,536 @@ bool Board::canCastleQueenSide(Colour colour) const {
         if (whiteKingMoved || whiteRookQueenMoved) return false;
         
         // Check if king and rook are still in their original positions
-        Piece* king = grid[0][4].get();  // e1
-        Piece* rook = grid[0][0].get();  // a1
-        if (!king || king->getType() != "King" || king->getColour() != Colour::WHITE) return false;
-        if (!rook || rook->getType() != "Rook" || rook->getColour() != Colour::WHITE) return false;
+        if (mailbox[4] != pieceIndex(Colour::WHITE, PieceType::KING)) return false;  // e1
+        if (mailbox[0] != pieceIndex(Colour::WHITE, PieceType::ROOK)) return false;  // a1
         
         // Check if path is clear
-        if (grid[0][1] || grid[0][2] || grid[0][3]) return false;  // b1, c1, d1 must be empty
+        if (occupiedBB & (squareBB(1) | squareBB(2) | squareBB(3))) return false;  // b1, c1, d1 must be empty
         
-        // King must not be in check
+        // King must not be in check, and must not pass through or land on an attacked square (b1 may be)
         if (isInCheck(colour)) return false;
+        if (isSquareAttacked(3, Colour::BLACK) || isSquareAttacked(2, Colour::BLACK)) return false;  // d1, c1
         return true;
     } else {
         if (blackKingMoved || blackRookQueenMoved) return false;
         
         // Check if king and rook are still in their original positions
-        Piece* king = grid[7][4].get();  // e8
-        Piece* rook = grid[7][0].get();  // a8
-        if (!king || king->getType() != "King" || king->getColour() != Colour::BLACK) return false;
-        if (!rook || rook->getType() != "Rook" || rook->getColour() != Colour::BLACK) return false;
+        if (mailbox[60] != pieceIndex(Colour::BLACK, PieceType::KING)) return false;  // e8
+        if (mailbox[56] != pieceIndex(Colour::BLACK, PieceType::ROOK)) return false;  // a8
         
         // Check if path is clear
-        if (grid[7][1] || grid[7][2] || grid[7][3]) return false;  // b8, c8, d8 must be empty
+        if (occupiedBB & (squareBB(57) | squareBB(58) | squareBB(59))) return false;  // b8, c8, d8 must be empty
         
-        // King must not be in check
+        // King must not be in check, and must not pass through or land on an attacked square (b8 may be)
         if (isInCheck(colour)) return false;
+        if (isSquareAttacked(59, Colour::WHITE) || isSquareAttacked(58, Colour::WHITE)) return false;  // d8, c8
         return true;
     }
 }
 
 bool Board::isEnPassant(const Position& from, const Position& to, Colour turn) const {// Checks for a pawn, and makes sure it can EnPassant
-    // Check if this is a valid en passant move
-    if (!getPiece(from) || getPiece(from)->getType() != "Pawn") return false;
-    
-    int direction = (turn == Colour::WHITE) ? 1 : -1;
+    if (!from.isValid() || !to.isValid()) return false;
+    int fromSq = toSquare(from);
+    if (mailbox[fromSq] != pieceIndex(turn, PieceType::PAWN)) return false;
     
-    // Must be diagonal move
-    if (abs(to.getCol() - from.getCol()) != 1 || (to.getRow() - from.getRow()) != direction) return false;
+    // Must be a diagonal step forward onto an empty square
+    int toSq = toSquare(to);
+    if (!(pawnAttacks(turn, fromSq) & squareBB(toSq)) || mailbox[toSq] != NO_PIECE) return false;
     
-    // Target square must be empty
-    if (getPiece(to)) return false;
-    
-    // There must be an enemy pawn beside our pawn
+    // There must be an enemy pawn beside our pawn, and it must have just moved two squares
+    Colour enemy = (turn == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
     Position enemyPawnPos(from.getRow(), to.getCol());
-    Piece* enemyPawn = getPiece(enemyPawnPos);
-    
-    if (!enemyPawn || enemyPawn->getType() != "Pawn" || enemyPawn->getColour() == turn) return false;
-    
-    // The enemy pawn must have just moved two squares
-    if (lastMoveFrom.getRow() == (turn == Colour::WHITE ? 7 : 2) && 
-        lastMoveTo == enemyPawnPos && 
-        abs(lastMoveFrom.getRow() - lastMoveTo.getRow()) == 2) {
-        return true;
-    }
-    
-    return false;
+    if (mailbox[toSquare(enemyPawnPos)] != pieceIndex(enemy, PieceType::PAWN)) return false;
+    return lastMoveFrom.getRow() == (turn == Colour::WHITE ? 7 : 2) &&
+           lastMoveTo == enemyPawnPos &&
+           abs(lastMoveFrom.getRow() - lastMoveTo.getRow()) == 2;
 }
 
 bool Board::isValidMove(const Position& from, const Position& to, Colour turn) const {
     if (!from.isValid() || !to.isValid()) return false; // Check position out of bounds. 
     
-    Piece* piece = getPiece(from);
-    if (!piece || piece->getColour() != turn) return false; // Can't move another colour's piece/ empty square
+    int index = mailbox[toSquare(from)];
+    if (index == NO_PIECE || colourOfIndex(index) != turn) return false; // Can't move another colour's piece/ empty square
     
-    Piece* targetPiece = getPiece(to);
-    if (targetPiece && targetPiece->getColour() == turn) return false;  // Can't capture own piece
-    
-    // Check if the piece can make this move
-    return piece->isValidMove(from, to, *this); // // Checks specific piece's validity
+    // moveTargets leaves out our own pieces, so this also stops us capturing them
+    return (moveTargets(toSquare(from)) & squareBB(toSquare(to))) != 0;
 }
 
-bool Board::wouldBeInCheck(const Position& from, const Position& to, Colour turn) const { // We simulate the move, then see if that would make the current King in check, then revert the board back to the OG state. 
-    // Make a temporary copy of the move
-    Piece* movingPiece = getPiece(from);
-    if (!movingPiece) return true;  // Invalid move (Empty Square) 
-    
-    // Clone the captured piece BEFORE making the move
-    std::unique_ptr<Piece> capturedPieceClone = nullptr;
-    Piece* capturedPiece = getPiece(to);
-    if (capturedPiece) {
-        capturedPieceClone = capturedPiece->clone();
+Bitboard Board::moveTargets(int square) const {
+    int index = mailbox[square];
+    if (index == NO_PIECE) return 0;
+    Colour colour = colourOfIndex(index);
+    Bitboard ours = pieces(colour);
+    
+    switch (typeOfIndex(index)) {
+        case PieceType::PAWN: {
+            Colour enemy = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+            int up = (colour == Colour::WHITE) ? 8 : -8;
+            Bitboard startRank = (colour == Colour::WHITE) ? RANK_1 << 8 : RANK_8 >> 8;
+            Bitboard targets = pawnAttacks(colour, square) & pieces(enemy);
+            int ahead = square + up;
+            if (ahead >= 0 && ahead < 64 && !(occupiedBB & squareBB(ahead))) {
+                targets |= squareBB(ahead);
+                if ((startRank & squareBB(square)) && !(occupiedBB & squareBB(ahead + up))) targets |= squareBB(ahead + up);
+            }
+            Bitboard empty = pawnAttacks(colour, square) & ~occupiedBB;  // Only en passant lands on an empty diagonal
+            while (empty) {
+                int to = popLsb(empty);
+                if (isEnPassant(toPosition(square), toPosition(to), colour)) targets |= squareBB(to);
+            }
+            return targets;
+        }
+        case PieceType::KNIGHT: return knightAttacks(square) & ~ours;
+        case PieceType::BISHOP: return bishopAttacks(square, occupiedBB) & ~ours;
+        case PieceType::ROOK:   return rookAttacks(square, occupiedBB) & ~ours;
+        case PieceType::QUEEN:  return queenAttacks(square, occupiedBB) & ~ours;
+        case PieceType::KING: {
+            Bitboard targets = kingAttacks(square) & ~ours;
+            // The castling checks make sure the king is still on its home square
+            if (canCastleKingSide(colour)) targets |= squareBB(square + 2);
+            if (canCastleQueenSide(colour)) targets |= squareBB(square - 2);
+            return targets;
+        }
+    }
+    return 0;
+}
+
+bool Board::wouldBeInCheck(const Position& from, const Position& to, Colour turn) const { // We play the move on a copy of the bitboards, then see if that would leave the current King in check.
+    if (mailbox[toSquare(from)] == NO_PIECE) return true;  // Invalid move (Empty Square) 
+    return kingAttackedAfter(moveFor(from, to, '\0'), turn);
+}
+
+bool Board::isSquareAttacked(int square, Colour byColour) const {
+    // Knight, king and pawn patterns from the square, then sliding rays to the first blocker
+    return attackedBy(pieceBB, occupiedBB, square, byColour);
+}
+
+int Board::see(Move move, const int values[6]) const {
+    int from = move.from(), to = move.to();
+    int moved = mailbox[from];
+    if (moved == NO_PIECE || move.kind() == Move::CASTLING) return 0;
+    
+    // gain[d] is what the side making capture d has won so far if the exchange stops there
+    int gain[32];
+    int depth = 0;
+    Bitboard occupancy = occupiedBB ^ squareBB(from);
+    if (move.kind() == Move::EN_PASSANT) {
+        gain[0] = values[static_cast<int>(PieceType::PAWN)];
+        occupancy ^= squareBB((from / 8) * 8 + to % 8);
+    } else {
+        gain[0] = mailbox[to] != NO_PIECE ? values[static_cast<int>(typeOfIndex(mailbox[to]))] : 0;
+    }
+    int onSquare = values[static_cast<int>(typeOfIndex(moved))];  // Worth of the piece that would be taken next
+    if (move.isPromotion()) {
+        gain[0] += values[static_cast<int>(move.promotion())] - values[static_cast<int>(PieceType::PAWN)];
+        onSquare = values[static_cast<int>(move.promotion())];
     }
     
-    // Temporarily make the move
-    const_cast<Board*>(this)->grid[to.getRow() - 1][to.getCol() - 1] = std::move(const_cast<Board*>(this)->grid[from.getRow() - 1][from.getCol() - 1]);
-    const_cast<Board*>(this)->grid[from.getRow() - 1][from.getCol() - 1] = nullptr;
+    Bitboard bishops = pieceBB[pieceIndex(Colour::WHITE, PieceType::BISHOP)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::BISHOP)];
+    Bitboard rooks = pieceBB[pieceIndex(Colour::WHITE, PieceType::ROOK)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::ROOK)];
+    Bitboard queens = pieceBB[pieceIndex(Colour::WHITE, PieceType::QUEEN)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::QUEEN)];
+    Bitboard attackers = attackersTo(to, occupancy) & occupancy;
+    Colour side = (colourOfIndex(moved) == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
     
-    bool inCheck = isInCheck(turn);
+    while (true) {
+        Bitboard ours = attackers & colourBB[colourIndex(side)];
+        if (!ours) break;
+        
+        // Least valuable attacker; a king may only take when nothing can take it back
+        int type = 0;
+        while (!(ours & pieceBB[pieceIndex(side, static_cast<PieceType>(type))])) type++;
+        if (static_cast<PieceType>(type) == PieceType::KING && (attackers & ~ours)) break;
+        
+        depth++;
+        gain[depth] = onSquare - gain[depth - 1];
+        onSquare = values[type];
+        
+        occupancy ^= squareBB(lsb(ours & pieceBB[pieceIndex(side, static_cast<PieceType>(type))]));
+        PieceType taken = static_cast<PieceType>(type);
+        if (taken == PieceType::PAWN || taken == PieceType::BISHOP || taken == PieceType::QUEEN) {
+            attackers |= bishopAttacks(to, occupancy) & (bishops | queens);
+        }
+        if (taken == PieceType::ROOK || taken == PieceType::QUEEN) {
+            attackers |= rookAttacks(to, occupancy) & (rooks | queens);
+        }
+        attackers &= occupancy;
+        side = (side == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    }
     
-    // Restore the board
-    const_cast<Board*>(this)->grid[from.getRow() - 1][from.getCol() - 1] = std::move(const_cast<Board*>(this)->grid[to.getRow() - 1][to.getCol() - 1]);
-    if (capturedPieceClone) {
-        const_cast<Board*>(this)->grid[to.getRow() - 1][to.getCol() - 1] = std::move(capturedPieceClone);
-    } else {
-        const_cast<Board*>(this)->grid[to.getRow() - 1][to.getCol() - 1] = nullptr;
+    // Each side picks the better of capturing and stopping, working back from the last capture
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
+
+int Board::threatenedLoss(int square, const int values[6]) const {
+    int index = mailbox[square];
+    if (index == NO_PIECE) return 0;
+    Colour enemy = (colourOfIndex(index) == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    Bitboard attackers = attackersTo(square, occupiedBB) & pieces(enemy);
+    for (int type = 0; type < 6 && attackers; type++) {
+        Bitboard bb = attackers & pieceBB[pieceIndex(enemy, static_cast<PieceType>(type))];
+        if (bb) return std::max(0, see(Move(lsb(bb), square), values));  // Cheapest attacker starts
+    }
+    return 0;
+}
+
+bool Board::isLegal(Move move) const {
+    int index = mailbox[move.from()];
+    if (move.isNull() || index == NO_PIECE || colourOfIndex(index) != sideToMove) return false;
+    if (!(moveTargets(move.from()) & squareBB(move.to()))) return false;
+    
+    // The kind must be the one the board would give the move (a stale move may claim en passant, say)
+    char promotion = move.isPromotion() ? "NBRQ"[static_cast<int>(move.promotion()) - static_cast<int>(PieceType::KNIGHT)] : '\0';
+    if (moveFor(toPosition(move.from()), toPosition(move.to()), promotion) != move) return false;
+    return !kingAttackedAfter(move, sideToMove);
+}
+
+bool Board::givesCheck(Move move) const {
+    int index = mailbox[move.from()];
+    if (index == NO_PIECE) return false;
+    Colour enemy = (colourOfIndex(index) == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    return kingAttackedAfter(move, enemy);
+}
+
+bool Board::kingAttackedAfter(Move move, Colour kingColour) const {
+    int from = move.from();
+    int to = move.to();
+    int moved = mailbox[from];
+    Colour mover = colourOfIndex(moved);
+    
+    Bitboard after[12];
+    std::copy(pieceBB, pieceBB + 12, after);
+    
+    // Captured piece, which sits beside the target square for en passant
+    int capturedSquare = (move.kind() == Move::EN_PASSANT) ? (from / 8) * 8 + to % 8 : to;
+    if (mailbox[capturedSquare] != NO_PIECE) after[mailbox[capturedSquare]] &= ~squareBB(capturedSquare);
+    
+    // Moving piece, promoted if it reaches the last rank
+    after[moved] &= ~squareBB(from);
+    int placed = move.isPromotion() ? pieceIndex(mover, move.promotion()) : moved;
+    after[placed] |= squareBB(to);
+    
+    // Castling rook
+    if (move.kind() == Move::CASTLING) {
+        bool kingSide = to > from;
+        int rook = pieceIndex(mover, PieceType::ROOK);
+        after[rook] ^= squareBB(kingSide ? from + 3 : from - 4) | squareBB(kingSide ? from + 1 : from - 1);
     }
     
-    return inCheck;
+    Bitboard occupancy = 0;
+    for (Bitboard bb : after) occupancy |= bb;
+    
+    Bitboard king = after[pieceIndex(kingColour, PieceType::KING)];
+    if (!king) return false;
+    Colour attacker = (kingColour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    return attackedBy(after, occupancy, lsb(king), attacker);
 }
 
-// by the time we get here, we made sure the move is valid in all aspects.
-void Board::makeMove(const Position& from, const Position& to, char promotion) {
-    Piece* piece = getPiece(from);
-    if (!piece) return;
-    
-    // Handle en passant capture
-    if (piece->getType() == "Pawn" && isEnPassant(from, to, piece->getColour())) {
-        Position enemyPawnPos(from.getRow(), to.getCol());
-        grid[enemyPawnPos.getRow() - 1][enemyPawnPos.getCol() - 1] = nullptr;
-        // When we capture a piece, it goes off the board, and becomes nullptr
-    }
-    
-    // Handle castling
-    if (piece->getType() == "King" && abs(to.getCol() - from.getCol()) == 2) {
-        // King-side castling
-        if (to.getCol() > from.getCol() && canCastleKingSide(piece->getColour())) {
-            grid[from.getRow() - 1][5] = std::move(grid[from.getRow() - 1][7]);  // Move rook
-            grid[from.getRow() - 1][7] = nullptr;
-        }
-        // Queen-side castling
-        else if (to.getCol() < from.getCol() && canCastleQueenSide(piece->getColour())) {
-            grid[from.getRow() - 1][3] = std::move(grid[from.getRow() - 1][0]);  // Move rook
-            grid[from.getRow() - 1][0] = nullptr;
+Move Board::moveFor(const Position& from, const Position& to, char promotion) const {
+    int fromSquare = toSquare(from);
+    int toSq = toSquare(to);
+    int index = mailbox[fromSquare];
+    if (index == NO_PIECE) return Move(fromSquare, toSq);
+    
+    PieceType type = typeOfIndex(index);
+    if (type == PieceType::PAWN) {
+        if (to.getRow() == 1 || to.getRow() == 8) return Move(fromSquare, toSq, Move::PROMOTION, promotionType(promotion));
+        if (from.getCol() != to.getCol() && mailbox[toSq] == NO_PIECE) return Move(fromSquare, toSq, Move::EN_PASSANT);
+    } else if (type == PieceType::KING && abs(to.getCol() - from.getCol()) == 2) {
+        return Move(fromSquare, toSq, Move::CASTLING);
+    }
+    return Move(fromSquare, toSq);
+}
+
+Bitboard Board::attackersTo(int square, Bitboard occupancy) const {
+    Bitboard queens = pieceBB[pieceIndex(Colour::WHITE, PieceType::QUEEN)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::QUEEN)];
+    Bitboard rooks = pieceBB[pieceIndex(Colour::WHITE, PieceType::ROOK)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::ROOK)];
+    Bitboard bishops = pieceBB[pieceIndex(Colour::WHITE, PieceType::BISHOP)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::BISHOP)];
+    Bitboard knights = pieceBB[pieceIndex(Colour::WHITE, PieceType::KNIGHT)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::KNIGHT)];
+    Bitboard kings = pieceBB[pieceIndex(Colour::WHITE, PieceType::KING)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::KING)];
+    return (pawnAttacks(Colour::BLACK, square) & pieces(Colour::WHITE, PieceType::PAWN))
+         | (pawnAttacks(Colour::WHITE, square) & pieces(Colour::BLACK, PieceType::PAWN))
+         | (knightAttacks(square) & knights)
+         | (kingAttacks(square) & kings)
+         | (bishopAttacks(square, occupancy) & (bishops | queens))
+         | (rookAttacks(square, occupancy) & (rooks | queens));
+}
+
+Bitboard Board::pinnedPieces(Colour colour, int kingSquare) const {
+    Colour enemy = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    Bitboard enemyQueens = pieces(enemy, PieceType::QUEEN);
+    
+    // Enemy sliders that would hit the king on an empty board; exactly one piece in between means a pin
+    Bitboard snipers = (rookAttacks(kingSquare, 0) & (pieces(enemy, PieceType::ROOK) | enemyQueens))
+                     | (bishopAttacks(kingSquare, 0) & (pieces(enemy, PieceType::BISHOP) | enemyQueens));
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = betweenSquares(kingSquare, popLsb(snipers)) & occupiedBB;
+        if (blockers && !(blockers & (blockers - 1))) pinned |= blockers & pieces(colour);
+    }
+    return pinned;
+}
+
+void Board::generateLegalMoves(Colour colour, std::vector<Move>& moves) const {
+    generateMoves(colour, moves, GenType::ALL);
+}
+
+void Board::generateLegalCaptures(Colour colour, std::vector<Move>& moves) const {
+    generateMoves(colour, moves, GenType::CAPTURES);
+}
+
+void Board::generateLegalQuiets(Colour colour, std::vector<Move>& moves) const {
+    generateMoves(colour, moves, GenType::QUIETS);
+}
+
+void Board::generateMoves(Colour colour, std::vector<Move>& moves, GenType type) const {
+    Colour enemy = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    Bitboard ours = pieces(colour);
+    Bitboard theirs = pieces(enemy);
+    Bitboard king = pieces(colour, PieceType::KING);
+    if (!king) return;  // Only possible half way through setup
+    int kingSquare = lsb(king);
+    // Where pieces other than pawns may go
+    Bitboard targetMask = type == GenType::CAPTURES ? theirs : type == GenType::QUIETS ? ~occupiedBB : ~ours;
+    
+    // King moves: the destination must not be attacked once the king has left its square,
+    // so sliders checking along the king's own line are seen through it
+    Bitboard kingTargets = kingAttacks(kingSquare) & targetMask;
+    Bitboard withoutKing = occupiedBB ^ king;
+    while (kingTargets) {
+        int to = popLsb(kingTargets);
+        if (!attackedBy(pieceBB, withoutKing, to, enemy)) moves.push_back(Move(kingSquare, to));
+    }
+    
+    Bitboard checkers = attackersTo(kingSquare, occupiedBB) & theirs;
+    if (checkers & (checkers - 1)) return;  // Double check: only the king can move
+    
+    // Everything else must capture a lone checker or block it
+    Bitboard checkMask = checkers ? (checkers | betweenSquares(kingSquare, lsb(checkers))) : ~Bitboard(0);
+    Bitboard pinned = pinnedPieces(colour, kingSquare);
+    
+    // Pieces other than pawns and the king: a pinned piece may only slide along its pin
+    Bitboard others = ours & ~pieces(colour, PieceType::PAWN) & ~king;
+    while (others) {
+        int from = popLsb(others);
+        Bitboard targets;
+        switch (typeOfIndex(mailbox[from])) {
+            case PieceType::KNIGHT: targets = knightAttacks(from); break;
+            case PieceType::BISHOP: targets = bishopAttacks(from, occupiedBB); break;
+            case PieceType::ROOK:   targets = rookAttacks(from, occupiedBB); break;
+            default:                targets = queenAttacks(from, occupiedBB); break;
         }
+        targets &= targetMask & checkMask;
+        if (pinned & squareBB(from)) targets &= lineThrough(kingSquare, from);
+        while (targets) moves.push_back(Move(from, popLsb(targets)));
     }
     
-    // Update special rule flags
-    if (piece->getType() == "King") {
-        if (piece->getColour() == Colour::WHITE) whiteKingMoved = true;
-        else blackKingMoved = true;
+    // Pawns: pushes onto empty squares, captures onto enemy pieces
+    int up = (colour == Colour::WHITE) ? 8 : -8;
+    Bitboard startRank = (colour == Colour::WHITE) ? RANK_1 << 8 : RANK_8 >> 8;
+    Bitboard lastRank = (colour == Colour::WHITE) ? RANK_8 : RANK_1;
+    Bitboard pawns = pieces(colour, PieceType::PAWN);
+    while (pawns) {
+        int from = popLsb(pawns);
+        Bitboard targets = pawnAttacks(colour, from) & theirs;
+        if (!(occupiedBB & squareBB(from + up))) {
+            targets |= squareBB(from + up);
+            if ((startRank & squareBB(from)) && !(occupiedBB & squareBB(from + 2 * up))) targets |= squareBB(from + 2 * up);
+        }
+        targets &= checkMask;
+        if (pinned & squareBB(from)) targets &= lineThrough(kingSquare, from);
+        
+        while (targets) {
+            int to = popLsb(targets);
+            bool capture = (theirs & squareBB(to)) != 0;
+            if (lastRank & squareBB(to)) {
+                // Queen promotions go with the captures, under-promotions (even capturing ones) with the quiet moves
+                if (type != GenType::QUIETS) moves.push_back(Move(from, to, Move::PROMOTION, PieceType::QUEEN));
+                if (type == GenType::CAPTURES) continue;
+                for (PieceType promotion : {PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT}) {
+                    moves.push_back(Move(from, to, Move::PROMOTION, promotion));
+                }
+            } else if (type == GenType::ALL || capture == (type == GenType::CAPTURES)) {
+                moves.push_back(Move(from, to));
+            }
+        }
     }
-    if (piece->getType() == "Rook") {
-        if (piece->getColour() == Colour::WHITE) {
-            if (from.getCol() == 1) whiteRookQueenMoved = true;
-            if (from.getCol() == 8) whiteRookKingMoved = true;
-        } else {
-            if (from.getCol() == 1) blackRookQueenMoved = true;
-            if (from.getCol() == 8) blackRookKingMoved = true;
+    
+    // En passant takes two pawns off one rank at once, which pins cannot describe, so it is simply tried
+    if (type != GenType::QUIETS && lastMoveTo.isValid() && abs(lastMoveTo.getRow() - lastMoveFrom.getRow()) == 2) {
+        int pushed = toSquare(lastMoveTo);
+        if (mailbox[pushed] == pieceIndex(enemy, PieceType::PAWN)) {
+            int passed = (toSquare(lastMoveFrom) + pushed) / 2;
+            Bitboard capturers = pawnAttacks(enemy, passed) & pieces(colour, PieceType::PAWN);
+            while (capturers) {
+                Move move(popLsb(capturers), passed, Move::EN_PASSANT);
+                if (!kingAttackedAfter(move, colour)) moves.push_back(move);
+            }
         }
     }
     
-    // Move the piece
-    grid[to.getRow() - 1][to.getCol() - 1] = std::move(grid[from.getRow() - 1][from.getCol() - 1]); // Place the piece at the new grid position (to)
-    grid[from.getRow() - 1][from.getCol() - 1] = nullptr; // Where we moved from is nullptr
+    // Castling (the board's castling checks cover check, the path and the squares passed through)
+    if (!checkers && type != GenType::CAPTURES) {
+        if (canCastleKingSide(colour)) moves.push_back(Move(kingSquare, kingSquare + 2, Move::CASTLING));
+        if (canCastleQueenSide(colour)) moves.push_back(Move(kingSquare, kingSquare - 2, Move::CASTLING));
+    }
+}
+
+// by the time we get here, we made sure the move is valid in all aspects.
+void Board::makeMove(Move move) {
+    if (mailbox[move.from()] == NO_PIECE) return;
     
-    // Mark piece as moved
-    grid[to.getRow() - 1][to.getCol() - 1]->setHasMoved(true);
+    doMove(move);
+    stateCount = 0;  // Game moves are never taken back, so the undo stack only has to hold simulated lines
+    
+    // Notify observers of board change
+    notifyObservers();
+}
+
+void Board::doMove(Move move) {
+    assert(stateCount < MAX_STATES);
+    StateInfo& st = states[stateCount++];
+    
+    // Save everything this move can overwrite
+    st.from = move.from();
+    st.to = move.to();
+    st.movedIndex = mailbox[st.from];
+    st.lastMoveFrom = lastMoveFrom;
+    st.lastMoveTo = lastMoveTo;
+    st.whiteKingMoved = whiteKingMoved;
+    st.blackKingMoved = blackKingMoved;
+    st.whiteRookKingMoved = whiteRookKingMoved;
+    st.whiteRookQueenMoved = whiteRookQueenMoved;
+    st.blackRookKingMoved = blackRookKingMoved;
+    st.blackRookQueenMoved = blackRookQueenMoved;
+    st.rookFrom = st.rookTo = -1;
+    st.key = key;
+    
+    // Castling rights and en passant file are re-hashed once the move is done
+    int epFile = enPassantFile();
+    key ^= zobrist.castling[castlingRights()];
+    if (epFile != -1) key ^= zobrist.enPassant[epFile];
+    
+    PieceType type = typeOfIndex(st.movedIndex);
+    Colour colour = colourOfIndex(st.movedIndex);
+    
+    // Handle en passant capture: the pawn taken sits beside ours, on the square it passed over
+    st.capturedSquare = (move.kind() == Move::EN_PASSANT) ? (st.from / 8) * 8 + st.to % 8 : st.to;
+    st.capturedIndex = mailbox[st.capturedSquare];
+    removePieceAt(st.capturedSquare);  // When we capture a piece, it goes off the board
+    
+    // Handle castling: the rook jumps to the other side of the king
+    if (move.kind() == Move::CASTLING) {
+        bool kingSide = st.to > st.from;
+        st.rookFrom = kingSide ? st.from + 3 : st.from - 4;  // h-file or a-file
+        st.rookTo = kingSide ? st.from + 1 : st.from - 1;
+        movePiece(st.rookFrom, st.rookTo);
+    }
+    
+    // Move the piece
+    movePiece(st.from, st.to);
     
     // Handle pawn promotion
-    if (piece->getType() == "Pawn") {
-        auto* pawn = dynamic_cast<Pawn*>(grid[to.getRow() - 1][to.getCol() - 1].get());
-        if (pawn && pawn->isPromotionRank(to) && promotion != '\0') {
-            Colour colour = pawn->getColour();
-            switch (promotion) {
-              // Overwrites pawn with Queen, Rook, Bishop, or Knight
-                case 'Q': case 'q':
-                    grid[to.getRow() - 1][to.getCol() - 1] = std::make_unique<Queen>(colour);
-                    break;
-                case 'R': case 'r':
-                    grid[to.getRow() - 1][to.getCol() - 1] = std::make_unique<Rook>(colour);
-                    break;
-                case 'B': case 'b':
-                    grid[to.getRow() - 1][to.getCol() - 1] = std::make_unique<Bishop>(colour);
-                    break;
-                case 'N': case 'n':
-                    grid[to.getRow() - 1][to.getCol() - 1] = std::make_unique<Knight>(colour);
-                    break;
-            }
-        }
+    if (move.isPromotion()) {
+        removePieceAt(st.to);
+        putPiece(pieceIndex(colour, move.promotion()), st.to);
     }
     
+    // Update special rule flags: a king move, or anything leaving or landing on a rook's corner
+    if (type == PieceType::KING) {
+        if (colour == Colour::WHITE) whiteKingMoved = true;
+        else blackKingMoved = true;
+    }
+    Bitboard touched = squareBB(st.from) | squareBB(st.to);
+    if (touched & squareBB(0)) whiteRookQueenMoved = true;   // a1
+    if (touched & squareBB(7)) whiteRookKingMoved = true;    // h1
+    if (touched & squareBB(56)) blackRookQueenMoved = true;  // a8
+    if (touched & squareBB(63)) blackRookKingMoved = true;   // h8
+    
     // Update last move for en passant
-    lastMoveFrom = from;
-    lastMoveTo = to;
+    lastMoveFrom = toPosition(st.from);
+    lastMoveTo = toPosition(st.to);
+    
+    sideToMove = (sideToMove == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    key ^= zobrist.blackToMove ^ zobrist.castling[castlingRights()];
+    epFile = enPassantFile();
+    if (epFile != -1) key ^= zobrist.enPassant[epFile];
+#ifdef BOARD_DEBUG
+    assert(key == computeKey());
+    assert(pawnKey == computePawnKey());
+    assert(scoresMatch());
+#endif
+}
+
+void Board::undoMove() {
+    assert(stateCount > 0);
+    const StateInfo& st = states[--stateCount];
+    
+    // Take the piece back (as the pawn it was, if it promoted)
+    if (mailbox[st.to] != st.movedIndex) {
+        removePieceAt(st.to);
+        putPiece(st.movedIndex, st.from);
+    } else {
+        movePiece(st.to, st.from);
+    }
+    if (st.rookFrom != -1) {
+        movePiece(st.rookTo, st.rookFrom);
+    }
+    if (st.capturedIndex != NO_PIECE) {
+        putPiece(st.capturedIndex, st.capturedSquare);
+    }
     
-    // Notify observers of board change
-    notifyObservers();
+    lastMoveFrom = st.lastMoveFrom;
+    lastMoveTo = st.lastMoveTo;
+    whiteKingMoved = st.whiteKingMoved;
+    blackKingMoved = st.blackKingMoved;
+    whiteRookKingMoved = st.whiteRookKingMoved;
+    whiteRookQueenMoved = st.whiteRookQueenMoved;
+    blackRookKingMoved = st.blackRookKingMoved;
+    blackRookQueenMoved = st.blackRookQueenMoved;
+    sideToMove = (sideToMove == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    key = st.key;  // Pieces were XORed back already; this also restores castling, en passant and side
+#ifdef BOARD_DEBUG
+    assert(key == computeKey());
+    assert(pawnKey == computePawnKey());
+    assert(scoresMatch());
+#endif
 }
 
 bool Board::isInCheckmate(Colour colour) const {
     if (!isInCheck(colour)) return false;
     
-    // Try all possible moves
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (grid[row][col] && grid[row][col]->getColour() == colour) {
-                Position from(row + 1, col + 1);
-                auto moves = grid[row][col]->getPossibleMoves(from, *this); // vector<Positions>
-                
-                for (const auto& to : moves) { // Check if King's colours can help us out of check , as well as if King can help itself.
-                    if (isValidMove(from, to, colour) && !wouldBeInCheck(from, to, colour)) {
-                        return false;  // Found a legal move
-                    }
-                }
-            }
-        }
-    }
-    
-    return true;  // No legal moves found
+    // In check with no legal move
+    std::vector<Move> moves;
+    generateLegalMoves(colour, moves);
+    return moves.empty();
 }
 
 bool Board::isInStalemate(Colour colour) const {
     if (isInCheck(colour)) return false;  // Can't be stalemate if in check
     
-    // Try all possible moves
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (grid[row][col] && grid[row][col]->getColour() == colour) {
-                Position from(row + 1, col + 1);
-                auto moves = grid[row][col]->getPossibleMoves(from, *this);
-                
-                for (const auto& to : moves) {
-                    if (isValidMove(from, to, colour) && !wouldBeInCheck(from, to, colour)) {
-                        return false;  // Found a legal move
-                    }
-                }
-            }
-        }
-    }
-    
-    return true;  // No legal moves found and not in check = stalemate
+    // No legal moves found and not in check = stalemate
+    std::vector<Move> moves;
+    generateLegalMoves(colour, moves);
+    return moves.empty();
 }
 
 void Board::addPiece(char pieceChar, const Position& pos) {
     if (!pos.isValid()) return;
     
-    Colour colour = (pieceChar >= 'A' && pieceChar <= 'Z') ? Colour::WHITE : Colour::BLACK;
-    char lowerChar = tolower(pieceChar); // Standardize the switch cases
-    
-    switch (lowerChar) {
-        case 'k':
-            grid[pos.getRow() - 1][pos.getCol() - 1] = std::make_unique<King>(colour);
-            break;
-        case 'q':
-            grid[pos.getRow() - 1][pos.getCol() - 1] = std::make_unique<Queen>(colour);
-            break;
-        case 'r':
-            grid[pos.getRow() - 1][pos.getCol() - 1] = std::make_unique<Rook>(colour);
-            break;
-        case 'b':
-            grid[pos.getRow() - 1][pos.getCol() - 1] = std::make_unique<Bishop>(colour);
-            break;
-        case 'n':
-            grid[pos.getRow() - 1][pos.getCol() - 1] = std::make_unique<Knight>(colour);
-            break;
-        case 'p':
-            grid[pos.getRow() - 1][pos.getCol() - 1] = std::make_unique<Pawn>(colour);
-            break;
+    int index = indexFromChar(pieceChar);
+    if (index != NO_PIECE) {
+        removePieceAt(toSquare(pos));  // Replace whatever was on pos
+        putPiece(index, toSquare(pos));
     }
+#ifdef BOARD_DEBUG
+    assert(key == computeKey());
+    assert(pawnKey == computePawnKey());
+    assert(scoresMatch());
+#endif
     
     // Notify observers of piece addition
     notifyObservers();
@@ -425,54 +837,39 @@ void Board::addPiece(char pieceChar, const Position& pos) {
 
 void Board::removePiece(const Position& pos) {
     if (!pos.isValid()) return;
-    grid[pos.getRow() - 1][pos.getCol() - 1] = nullptr;
+    removePieceAt(toSquare(pos));
+#ifdef BOARD_DEBUG
+    assert(key == computeKey());
+    assert(pawnKey == computePawnKey());
+    assert(scoresMatch());
+#endif
     
     // Notify observers of piece removal
     notifyObservers();
 }
 
+int Board::kingSquare(Colour colour) const {
+    Bitboard king = pieces(colour, PieceType::KING);
+    return king ? lsb(king) : -1;
+}
+
 int Board::countPieces(char piece) const {
-    int count = 0;
-    char lowerPiece = tolower(piece); 
-    bool isWhite = (piece >= 'A' && piece <= 'Z'); 
-    
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (grid[row][col]) {
-                char pieceSymbol = grid[row][col]->getSymbol(); // Find random piece
-                if (tolower(pieceSymbol) == lowerPiece) {
-                    bool pieceIsWhite = (pieceSymbol >= 'A' && pieceSymbol <= 'Z');
-                    if (pieceIsWhite == isWhite) {
-                        count++;
-                    }
-                }
-            }
-        }
-    }
-    
-    return count;
+    int index = indexFromChar(piece);
+    return index == NO_PIECE ? 0 : popCount(pieceBB[index]);
 }
 
-bool Board::hasPawnsOnEndRanks() {
-    // Check first row (row 1)
-    for (int col = 0; col < 8; col++) {
-        if (grid[0][col] && grid[0][col]->getType() == "Pawn") return true;
-    }
-    
-    // Check last row (row 8)
-    for (int col = 0; col < 8; col++) {
-        if (grid[7][col] && grid[7][col]->getType() == "Pawn") return true;
-    }
-    
-    return false;
+bool Board::hasPawnsOnEndRanks() const {
+    // Check first row (row 1) and last row (row 8)
+    Bitboard pawns = pieceBB[pieceIndex(Colour::WHITE, PieceType::PAWN)] | pieceBB[pieceIndex(Colour::BLACK, PieceType::PAWN)];
+    return (pawns & (RANK_1 | RANK_8)) != 0;
 }
 
 bool Board::isValidSetup() const {
     // Check for exactly one king of each color
-    if (countPieces('K') != 1 || countPieces('k') != 1) return false;
+    if (pieceCount(Colour::WHITE, PieceType::KING) != 1 || pieceCount(Colour::BLACK, PieceType::KING) != 1) return false;
     
     // Check for no pawns on first or last row
-    if (const_cast<Board*>(this)->hasPawnsOnEndRanks()) return false;
+    if (hasPawnsOnEndRanks()) return false;
     
     // Check that neither king is in check
     if (isInCheck(Colour::WHITE) || isInCheck(Colour::BLACK)) return false;
@@ -481,17 +878,87 @@ bool Board::isValidSetup() const {
 }
 
 void Board::clear() {
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            grid[row][col] = nullptr;
-        }
+    for (int i = 0; i < 12; i++) pieceBB[i] = 0;
+    colourBB[0] = colourBB[1] = 0;
+    occupiedBB = 0;
+    for (int square = 0; square < 64; square++) {
+        mailbox[square] = NO_PIECE;
     }
+    pawnKey = 0;
+    mgScore = egScore = phase = 0;
+    key = computeKey();  // No pieces left, only side to move and castling rights
 }
 
 void Board::init() {
     setupStartingPosition();
 }
 
+void Board::setFen(const std::string& fen) {
+    std::istringstream iss(fen);
+    std::string placement, side, castling = "-", enPassant = "-";
+    if (!(iss >> placement >> side)) throw std::invalid_argument("Invalid FEN: " + fen);
+    iss >> castling >> enPassant;  // Optional, as are the move counters after them
+    
+    // Everything is checked before the board is touched, so a bad FEN leaves the position as it was.
+    // Beyond the syntax, move generation needs one king a side and no pawn on the first or last rank.
+    bool valid = (side == "w" || side == "b")
+        && (castling == "-" || castling.find_first_not_of("KQkq") == std::string::npos)
+        && (enPassant == "-" || (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h'
+                                 && (enPassant[1] == '3' || enPassant[1] == '6')));
+    std::vector<std::pair<int, int>> placed;  // Piece index and square
+    int kings[2] = {0, 0};
+    int row = 8, col = 1;
+    for (char c : placement) {
+        if (!valid) break;
+        if (c == '/') {
+            valid = col == 9 && row > 1;  // Every rank adds up to exactly 8 files
+            row--;
+            col = 1;
+        } else if (c >= '1' && c <= '8') {
+            col += c - '0';
+            valid = col <= 9;
+        } else {
+            int index = indexFromChar(c);
+            valid = index != NO_PIECE && col <= 8;
+            if (!valid) break;
+            PieceType type = typeOfIndex(index);
+            if (type == PieceType::KING) kings[colourOfIndex(index) == Colour::WHITE ? 0 : 1]++;
+            valid = type != PieceType::PAWN || (row != 1 && row != 8);
+            placed.emplace_back(index, toSquare(Position(row, col)));
+            col++;
+        }
+    }
+    if (!valid || row != 1 || col != 9 || kings[0] != 1 || kings[1] != 1) throw std::invalid_argument("Invalid FEN: " + fen);
+    
+    clear();
+    for (const auto& piece : placed) putPiece(piece.first, piece.second);
+    
+    // Castling rights become the "has moved" flags: no K means the h1 rook counts as moved, and so on
+    whiteRookKingMoved = castling.find('K') == std::string::npos;
+    whiteRookQueenMoved = castling.find('Q') == std::string::npos;
+    blackRookKingMoved = castling.find('k') == std::string::npos;
+    blackRookQueenMoved = castling.find('q') == std::string::npos;
+    whiteKingMoved = whiteRookKingMoved && whiteRookQueenMoved;
+    blackKingMoved = blackRookKingMoved && blackRookQueenMoved;
+    
+    // An en passant square means the last move was a double pawn push over it
+    lastMoveFrom = Position(0, 0);
+    lastMoveTo = Position(0, 0);
+    if (enPassant.size() == 2) {
+        int epCol = enPassant[0] - 'a' + 1;
+        int epRow = enPassant[1] - '0';
+        int direction = (epRow == 3) ? 1 : -1;  // Which way the pawn went
+        lastMoveFrom = Position(epRow - direction, epCol);
+        lastMoveTo = Position(epRow + direction, epCol);
+    }
+    
+    sideToMove = (side == "b") ? Colour::BLACK : Colour::WHITE;
+    stateCount = 0;
+    key = computeKey();
+    
+    notifyObservers();
+}
+
 // Observer pattern implementation
 void Board::addObserver(ChessDisplay* observer) {
     if (observer) {
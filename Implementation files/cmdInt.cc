@@ -4,17 +4,54 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <cstdlib>
 #include "game.h"
 #include "position.h"
 #include "textDisplay.h"
 #include "graphicalDisplay.h"
 #include "board.h"
+#include "bench.h"
+#include "perft.h"
+#include "nnue.h"
 
 using namespace std;
 
+namespace {
+// Pawns with two decimals, or moves to mate
+string formatScore(int score) {
+    ostringstream out;
+    if (score > MATE_SCORE - 1000 || score < -MATE_SCORE + 1000) {
+        out << (score > 0 ? "mate " : "-mate ") << (MATE_SCORE - abs(score) + 1) / 2;
+    } else {
+        out << (score >= 0 ? "+" : "-") << abs(score) / 100 << "." << abs(score) / 10 % 10 << abs(score) % 10;
+    }
+    return out.str();
+}
+
+// One short line per principal variation, so a depth's results can be compared at a glance
+void printProgress(const SearchProgress& progress) {
+    cout << "depth " << progress.depth << " (" << progress.nodes << " nodes, " << progress.elapsedMs << " ms)\n";
+    for (size_t i = 0; i < progress.lines.size(); i++) {
+        const PrincipalVariation& line = progress.lines[i];
+        cout << "  " << i + 1 << ". " << formatScore(line.score) << " ";
+        for (Move move : line.moves) cout << " " << move.toString();
+        cout << "\n";
+    }
+    cout << flush;
+}
+
+const long long HINT_MS = 1000;  // Search time for a hint when the engine is not already thinking
+}
+
 // ==========================
 // Cleanup Game Memory
 // ==========================
+CommandInterpreter::~CommandInterpreter() {
+    abandonEngine = true;
+    stopEngine = true;
+    waitForEngine();
+}
+
 void CommandInterpreter::cleanup() {
     // RAII: unique_ptr automatically handles cleanup
     game.reset();
@@ -59,11 +96,15 @@ void CommandInterpreter::run() {
 
     while (getline(cin, command)) {
         try {
-            handleCommand(command);
+            if (!handleEngineCommand(command)) {
+                waitForEngine();  // Anything else may change the game, so the engine's move comes first
+                handleCommand(command);
+            }
         } catch (const exception& e) {
             cerr << "Error: " << e.what() << endl;          // catches error depending on which command throws
         }
     }
+    waitForEngine();
 
     if (game) {
         game->displayScore();
@@ -73,6 +114,196 @@ void CommandInterpreter::run() {
     cout << "Exiting. Goodbye!\n";
 }
 
+// Engine Thread ===================================================================
+
+void CommandInterpreter::startEngineMove() {
+    stopEngine = false;
+    abandonEngine = false;
+    pondering = false;
+    ponderHit = false;
+    ponderAllowed = ponderEnabled;
+    {
+        lock_guard<mutex> lock(progressMutex);
+        engineProgress = SearchProgress();
+        engineStart = chrono::steady_clock::now();
+    }
+    engineColour = game->getCurrentTurn();
+    engineThinking = true;
+    
+    engineThread = thread([this] {
+        SearchProgressCallback report = [this](const SearchProgress& progress) {
+            lock_guard<mutex> lock(progressMutex);
+            engineProgress = progress;
+        };
+        try {
+            Move move = game->thinkComputerMove(&stopEngine, report);
+            while (!abandonEngine) {
+                {
+                    lock_guard<mutex> lock(engineMutex);
+                    game->playComputerMove(move);  // The hand-off: input waits for engineThinking to clear
+                    if (!startPonder(move, report)) break;
+                }
+                move = game->ponderComputerMove();
+                // A search that ends by itself (mate found) still waits to hear whether the reply came
+                while (pondering && !abandonEngine) this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl;
+        }
+        engineThinking = false;
+    });
+}
+
+bool CommandInterpreter::startPonder(Move played, const SearchProgressCallback& report) {
+    if (!ponderAllowed || !game->isGameInProgress()) return false;
+    Player* opponent = game->getCurrentPlayer();
+    if (!opponent || opponent->getType() != "Human") return false;
+    
+    // The reply expected is the second move of the line the engine just played
+    PrincipalVariation line;
+    {
+        lock_guard<mutex> lock(progressMutex);
+        if (engineProgress.lines.empty()) return false;
+        line = engineProgress.lines[0];
+        ponderDepth = engineProgress.depth;
+        engineProgress = SearchProgress();
+        engineStart = chrono::steady_clock::now();
+    }
+    if (line.moves.size() < 2 || line.moves[0] != played || !game->getBoard()->isLegal(line.moves[1])) return false;
+    
+    ponderLine = line;
+    ponderMove = line.moves[1];
+    game->preparePonder(ponderMove, &stopEngine, &pondering, report);
+    cout << "Pondering on " << ponderMove.toString() << "." << endl;
+    pondering = true;  // Last: the input side may now play the reply
+    return true;
+}
+
+void CommandInterpreter::waitForEngine() {
+    {
+        lock_guard<mutex> lock(engineMutex);
+        ponderAllowed = false;
+        if (pondering) {  // Nobody wants the speculative search any more; what it stored in the table stays
+            abandonEngine = true;
+            stopEngine = true;
+        }
+    }
+    if (engineThread.joinable()) engineThread.join();
+    pondering = false;
+    ponderHit = false;
+}
+
+bool CommandInterpreter::handleEngineCommand(const string& cmd) {
+    istringstream iss(cmd);
+    string keyword;
+    iss >> keyword;
+    bool thinking = engineThinking;
+    
+    if (keyword == "move" && pondering) {    // move e7 e5 while pondering: a ponder hit, or a miss that drops the search
+        vector<string> args;
+        string arg;
+        while (iss >> arg) args.push_back(arg);
+        if (args.empty()) {
+            if (!ponderHit) return false;
+            {
+                lock_guard<mutex> lock(progressMutex);
+                engineStart = chrono::steady_clock::now();
+            }
+            ponderHit = false;
+            pondering = false;  // The search carries on where it is, now on the engine's clock
+        } else {
+            if (ponderHit || args.size() < 2 || args.size() > 3) return false;
+            Position from = converter(args[0]);
+            Position to = converter(args[1]);
+            char promotion = (args.size() == 3) ? args[2][0] : '\0';
+            if (game->getBoard()->moveFor(from, to, promotion) != ponderMove) return false;  // Miss
+            game->makePlayerMove(from, to, promotion);
+            ponderHit = true;
+            cout << "Ponder hit.\n";
+        }
+
+    } else if (keyword == "stop") {    // stop - play the engine's best move so far
+        if (!thinking) throw runtime_error("The engine is not thinking.");
+        if (pondering && !ponderHit) {
+            waitForEngine();
+            cout << "Pondering stopped.\n";
+        } else {
+            pondering = false;
+            stopEngine = true;
+        }
+
+    } else if (keyword == "hint") {    // hint - the engine's current best line, or a quick search for the side to move
+        SearchProgress progress;
+        if (pondering && !ponderHit) {
+            // The engine's own guess at the reply, scored for the side that makes it
+            progress.depth = ponderDepth;
+            PrincipalVariation line;
+            line.score = -ponderLine.score;
+            line.moves.assign(ponderLine.moves.begin() + 1, ponderLine.moves.end());
+            progress.lines.push_back(line);
+        } else if (thinking) {
+            lock_guard<mutex> lock(progressMutex);
+            progress = engineProgress;
+        } else {
+            waitForEngine();
+            if (!game || !game->isGameInProgress()) throw runtime_error("No game in progress.");
+            SearchLimits limits;
+            limits.hardMs = HINT_MS;
+            game->analyse(limits, [&progress](const SearchProgress& latest) { progress = latest; });
+        }
+        if (progress.lines.empty()) {
+            cout << "No hint yet.\n";
+        } else {
+            const PrincipalVariation& line = progress.lines[0];
+            cout << "Hint: " << line.moves[0].toString() << " (" << formatScore(line.score) << " at depth " << progress.depth << "):";
+            for (Move move : line.moves) cout << " " << move.toString();
+            cout << "\n";
+        }
+
+    } else if (keyword == "status") {    // status - who is to move, and how the engine's search is going
+        if (thinking) {
+            SearchProgress progress;
+            long long ms;
+            {
+                lock_guard<mutex> lock(progressMutex);
+                progress = engineProgress;
+                ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - engineStart).count();
+            }
+            cout << (engineColour == Colour::WHITE ? "White" : "Black") << " engine ";
+            if (pondering && !ponderHit) cout << "pondering on " << ponderMove.toString();
+            else if (pondering) cout << "pondering (hit, waiting for move)";
+            else cout << "thinking";
+            cout << " for " << ms << " ms";
+            if (!progress.lines.empty()) {
+                cout << ", depth " << progress.depth << " done, best " << progress.lines[0].moves[0].toString()
+                     << " (" << formatScore(progress.lines[0].score) << ")";
+            }
+            cout << ".\n";
+        } else {
+            waitForEngine();
+            if (!game || !game->isGameInProgress()) {
+                cout << "No game in progress.\n";
+            } else {
+                Colour turn = game->getCurrentTurn();
+                cout << (turn == Colour::WHITE ? "White" : "Black") << " to move ("
+                     << game->getPlayer(turn)->getType() << ").\n";
+            }
+        }
+
+    } else if (keyword == "resign" && thinking) {    // resign - while the engine thinks, its human opponent resigns
+        abandonEngine = true;
+        stopEngine = true;
+        waitForEngine();
+        Colour opponent = (engineColour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+        Player* player = game->getPlayer(opponent);
+        game->resign(player && player->getType() == "Human" ? opponent : engineColour);
+
+    } else {
+        return false;
+    }
+    return true;
+}
+
 // 
 // Handle Individual Commands ===================================================================
 // 
@@ -82,9 +313,11 @@ void CommandInterpreter::handleCommand(const string& cmd) {
     iss >> keyword;
 
     if (keyword == "game") {    
-        string white_p1;    // the format for the commands is  human, computer1, computer2 ... computer4
+        string white_p1;    // the format for the commands is  human, computer1, computer2 ... computer5
         string black_p2;
         iss >> white_p1 >> black_p2;
+        double minutes = 0, incrementSeconds = 0;   // optional clock: game human computer5 5 3  (5 minutes + 3 seconds a move)
+        iss >> minutes >> incrementSeconds;
 
         // Preserve scores from previous games
         int prevWhiteScore = 0, prevBlackScore = 0;
@@ -105,6 +338,11 @@ void CommandInterpreter::handleCommand(const string& cmd) {
         
         // Restore previous scores
         game->setScores(prevWhiteScore, prevBlackScore);
+        game->setHashSize(hashSizeMB);
+        game->setEvalCacheSize(evalCacheMB);
+        game->setNetwork(network);
+        game->setThreads(searchThreads);
+        game->setClock(static_cast<long long>(minutes * 60000), static_cast<long long>(incrementSeconds * 1000));
         
         game->startGame(white_p1, black_p2);
         
@@ -129,7 +367,8 @@ void CommandInterpreter::handleCommand(const string& cmd) {
         }
 
         if (grid_pos_vec.empty()) {
-            game->makeComputerMove();
+            if (game->isGameInProgress()) startEngineMove();  // Returns at once; the worker plays the move
+            else game->makeComputerMove();
         } else if (grid_pos_vec.size() == 2 || grid_pos_vec.size() == 3) {
             Position from = converter(grid_pos_vec[0]);
             Position to = converter(grid_pos_vec[1]);
@@ -140,6 +379,89 @@ void CommandInterpreter::handleCommand(const string& cmd) {
             throw runtime_error("Invalid move syntax.");
         }
 
+    } else if (keyword == "hash") {    // hash 64 - transposition table size in MB for engine players
+        int megabytes = 0;
+        if (!(iss >> megabytes) || megabytes < 1) throw runtime_error("Usage: hash <megabytes>");
+        hashSizeMB = megabytes;
+        if (game) game->setHashSize(hashSizeMB);
+        cout << "Transposition table size set to " << hashSizeMB << " MB.\n";
+
+    } else if (keyword == "evalcache") {    // evalcache 8 - eval cache size in MB for engine players
+        int megabytes = 0;
+        if (!(iss >> megabytes) || megabytes < 1) throw runtime_error("Usage: evalcache <megabytes>");
+        evalCacheMB = megabytes;
+        if (game) game->setEvalCacheSize(evalCacheMB);
+        cout << "Eval cache size set to " << evalCacheMB << " MB.\n";
+
+    } else if (keyword == "nnue") {    // nnue net.bin / nnue default / nnue off / nnue save net.bin - network evaluation for engine players
+        string argument;
+        if (!(iss >> argument)) throw runtime_error("Usage: nnue <file>|default|off|save <file>");
+        if (argument == "save") {
+            string path;
+            if (!(iss >> path)) throw runtime_error("Usage: nnue save <file>");
+            if (!network) throw runtime_error("No network in use.");
+            network->save(path);
+            cout << "Network saved to " << path << ".\n";
+        } else {
+            if (argument == "off") network.reset();
+            else if (argument == "default") network = NnueNetwork::embedded();
+            else network = NnueNetwork::fromFile(argument);
+            if (game) game->setNetwork(network);
+            if (network) {
+                cout << "Engine players evaluate with the " << network->getSource() << " network ("
+                     << NnueNetwork::kernelName() << ").\n";
+            } else {
+                cout << "Engine players evaluate with the hand-written evaluation.\n";
+            }
+        }
+
+    } else if (keyword == "ponder") {    // ponder off - stop engines searching on a human opponent's time
+        string setting;
+        if (!(iss >> setting) || (setting != "on" && setting != "off")) throw runtime_error("Usage: ponder on|off");
+        ponderEnabled = (setting == "on");
+        cout << "Pondering " << (ponderEnabled ? "on" : "off") << ".\n";
+
+    } else if (keyword == "threads") {    // threads 8 - search threads for engine players (Lazy SMP)
+        int threads = 0;
+        if (!(iss >> threads) || threads < 1 || threads > MAX_SEARCH_THREADS) {
+            throw runtime_error("Usage: threads <1-" + std::to_string(MAX_SEARCH_THREADS) + ">");
+        }
+        searchThreads = threads;
+        if (game) game->setThreads(searchThreads);
+        cout << "Engine players will search on " << searchThreads << " thread(s).\n";
+
+    } else if (keyword == "perft" || keyword == "divide") {    // perft 5 / divide 5 - count legal move paths from the current position
+        int depth = 0;
+        if (!(iss >> depth) || depth < 1) throw runtime_error("Usage: " + keyword + " <depth>");
+        
+        // Work on a copy so nothing is redrawn; without a game, use the starting position
+        std::unique_ptr<Board> board;
+        if (game && game->getBoard()) {
+            board = std::make_unique<Board>(*game->getBoard());
+        } else {
+            board = std::make_unique<Board>();
+            board->setupStartingPosition();
+        }
+        if (keyword == "perft") printPerft(*board, depth);
+        else divide(*board, depth);
+
+    } else if (keyword == "analyse") {    // analyse 3 10 - best 3 moves of the current position, searching for 10 seconds
+        int lineCount = 3;
+        double seconds = 5;
+        iss >> lineCount >> seconds;
+        if (lineCount < 1 || seconds <= 0) throw runtime_error("Usage: analyse [lines] [seconds]");
+        if (!game) throw runtime_error("No position to analyse.");
+        SearchLimits limits;
+        limits.multiPV = lineCount;
+        limits.hardMs = static_cast<long long>(seconds * 1000);
+        game->analyse(limits, printProgress);
+
+    } else if (keyword == "bench") {    // bench 8 7 - time a fixed position set on 1..8 threads to depth 7
+        int maxThreads = searchThreads, depth = 6;
+        iss >> maxThreads >> depth;
+        if (maxThreads < 1 || maxThreads > MAX_SEARCH_THREADS || depth < 1) throw runtime_error("Usage: bench [threads] [depth]");
+        runBench(maxThreads, depth, hashSizeMB, evalCacheMB);
+
     } else if (keyword == "resign") {
         if (!game) throw runtime_error("No game in progress.");
         game->resign();
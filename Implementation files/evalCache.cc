@@ -0,0 +1,40 @@
+#include "evalCache.h"
+
+namespace {
+// The low 16 bits of an entry hold the score; the rest must match the key's top 48 bits
+const uint64_t KEY_BITS = ~uint64_t(0xFFFF);
+}
+
+EvalCache::EvalCache(int megabytes) : entryMask(0), sizeMB(0) {
+    resize(megabytes);
+}
+
+void EvalCache::resize(int megabytes) {
+    if (megabytes < 1) megabytes = 1;
+    
+    // Largest power-of-two entry count that fits in the requested size
+    uint64_t bytes = static_cast<uint64_t>(megabytes) * 1024 * 1024;
+    uint64_t count = 1;
+    while (count * 2 * sizeof(std::atomic<uint64_t>) <= bytes) count *= 2;
+    
+    entries.reset(new std::atomic<uint64_t>[count]);
+    entryMask = count - 1;
+    sizeMB = megabytes;
+    clear();
+}
+
+void EvalCache::clear() {
+    for (uint64_t i = 0; i <= entryMask; i++) entries[i].store(0, std::memory_order_relaxed);
+}
+
+bool EvalCache::probe(Key key, int& score) const {
+    uint64_t data = entries[key & entryMask].load(std::memory_order_relaxed);
+    if (data == 0 || ((data ^ key) & KEY_BITS) != 0) return false;
+    score = static_cast<int16_t>(data);
+    return true;
+}
+
+void EvalCache::store(Key key, int score) {
+    uint64_t data = (key & KEY_BITS) | static_cast<uint16_t>(score);
+    entries[key & entryMask].store(data, std::memory_order_relaxed);
+}
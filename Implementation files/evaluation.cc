@@ -0,0 +1,56 @@
+#include "evaluation.h"
+#include "board.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+// Endgame bonus per step of rank a passed pawn has advanced, per square of king distance
+// from the square in front of it: their king far away is worth more than ours close by
+const int THEIR_KING_DISTANCE_EG = 5;
+const int OUR_KING_DISTANCE_EG = 2;
+
+int distance(int a, int b) { return std::max(std::abs(a / 8 - b / 8), std::abs(a % 8 - b % 8)); }
+
+// Kings move on nearly every turn, so this is worked out each time from the pawn table's passed pawns
+int passedPawnKings(const Board& board, Bitboard passed) {
+    int eg = 0;
+    for (Colour colour : {Colour::WHITE, Colour::BLACK}) {
+        Colour enemy = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+        int ourKing = board.kingSquare(colour), theirKing = board.kingSquare(enemy);
+        if (ourKing < 0 || theirKing < 0) continue;  // Setup mode
+        
+        int bonus = 0;
+        Bitboard pawns = passed & board.pieces(colour, PieceType::PAWN);
+        while (pawns) {
+            int square = popLsb(pawns);
+            int rank = (colour == Colour::WHITE) ? square / 8 : 7 - square / 8;  // 1-6: a passed pawn is never on its last rank
+            int stop = square + ((colour == Colour::WHITE) ? 8 : -8);
+            bonus += (rank - 1) * (THEIR_KING_DISTANCE_EG * distance(theirKing, stop) - OUR_KING_DISTANCE_EG * distance(ourKing, stop));
+        }
+        eg += (colour == Colour::WHITE) ? bonus : -bonus;
+    }
+    return eg;
+}
+}
+
+int evaluate(const Board& board, PawnTable* pawns) {
+    int mg = board.midgameScore();
+    int eg = board.endgameScore();
+    
+    // Pawn structure changes rarely, so during a search it nearly always comes from the pawn table
+    PawnTable::Entry scratch;
+    const PawnTable::Entry* entry = &scratch;
+    if (pawns) {
+        entry = &pawns->probe(board);
+    } else {
+        evaluatePawns(board, scratch);
+    }
+    mg += entry->mg;
+    eg += entry->eg + passedPawnKings(board, entry->passed);
+    
+    // The board keeps the middlegame and endgame sums as it changes; blend them by how much
+    // material is left, so the king walks to the centre as the pieces come off
+    int phase = std::min(board.gamePhase(), MAX_PHASE);
+    int score = (mg * phase + eg * (MAX_PHASE - phase)) / MAX_PHASE;  // White's point of view
+    return board.getSideToMove() == Colour::WHITE ? score : -score;
+}
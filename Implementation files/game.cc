@@ -3,15 +3,33 @@
 #include "playerFactory.h"
 #include "display.h"
 #include "board.h"
+#include "transpositionTable.h"
+#include "evalCache.h"
+#include "pawnTable.h"
 #include <iostream>
+#include <iomanip>
+#include <sstream>
 #include <stdexcept>
 
+namespace {
+// Clock time as m:ss.t
+std::string formatClock(long long ms) {
+    std::ostringstream out;
+    out << ms / 60000 << ":" << std::setw(2) << std::setfill('0') << (ms / 1000) % 60 << "." << (ms / 100) % 10;
+    return out.str();
+}
+}
+
 Game::Game() 
-    : currentTurn(Colour::WHITE)
+    : transpositionTable(std::make_unique<TranspositionTable>())
+    , evalCache(std::make_unique<EvalCache>())
+    , pawnTables(std::make_unique<PawnTables>())
+    , currentTurn(Colour::WHITE)
     , gameInProgress(false)
     , isSetupBoard(false)
     , whiteScore(0)
-    , blackScore(0) {
+    , blackScore(0)
+    , searchThreads(1) {
     // Initialize board and command interpreter when we have those classes
     // For now, just initialize the basic state
 }
@@ -23,8 +41,8 @@ Game::~Game() = default;
 void Game::initializePlayers(const std::string& whitePlayerType, const std::string& blackPlayerType) {
     try {
         // Create players using the factory
-        whitePlayer = PlayerFactory::createPlayer(whitePlayerType, Colour::WHITE);
-        blackPlayer = PlayerFactory::createPlayer(blackPlayerType, Colour::BLACK);
+        whitePlayer = PlayerFactory::createPlayer(whitePlayerType, Colour::WHITE, transpositionTable.get(), evalCache.get(), pawnTables.get());
+        blackPlayer = PlayerFactory::createPlayer(blackPlayerType, Colour::BLACK, transpositionTable.get(), evalCache.get(), pawnTables.get());
         
         std::cout << "Initialized players:" << std::endl;
         std::cout << "White: " << whitePlayer->getType() << std::endl;
@@ -74,11 +92,12 @@ void Game::startGame(const std::string& white_p1, const std::string& black_p2) {
             gameInProgress = false;             // Will be set to true after setup completes
             board->clearGameHistory();          // Clear move history, captured pieces, etc.
             board->resetSpecialRules();         // Reset castling rights, en passant, etc.
-            // Keep currentTurn as set in setup mode (don't force it to WHITE)
+            board->setSideToMove(currentTurn);  // Keep currentTurn as set in setup mode (don't force it to WHITE)
         }
         
         gameInProgress = true;
         std::cout << "New game started. " << (currentTurn == Colour::WHITE ? "White" : "Black") << " goes first." << std::endl;
+        clock.startTurn();
         announceCurrentPlayer();
     } catch (const std::exception& e) {
         std::cerr << "Error starting game: " << e.what() << std::endl;
@@ -99,6 +118,25 @@ void Game::setScores(int white, int black) {
     blackScore = black;
 }
 
+void Game::setHashSize(int megabytes) {
+    if (megabytes != transpositionTable->getSizeMB()) {
+        transpositionTable->resize(megabytes);
+    }
+}
+
+void Game::setEvalCacheSize(int megabytes) {
+    if (megabytes != evalCache->getSizeMB()) {
+        evalCache->resize(megabytes);
+    }
+}
+
+void Game::setNetwork(std::shared_ptr<const NnueNetwork> nnue) {
+    if (nnue != network) {
+        network = std::move(nnue);
+        evalCache->clear();  // Scores from the other evaluator
+    }
+}
+
 void Game::announceCurrentPlayer() {
     if (!gameInProgress) return;
     
@@ -109,16 +147,40 @@ void Game::announceCurrentPlayer() {
     std::string playerType = currentPlayer->getType();
     
     std::cout << playerColor << " player's turn (" << playerType << ")" << std::endl;
+    if (clock.isEnabled()) {
+        std::cout << "Clock - White: " << formatClock(clock.getRemainingMs(Colour::WHITE))
+                  << " | Black: " << formatClock(clock.getRemainingMs(Colour::BLACK)) << std::endl;
+    }
 } 
 
+void Game::setClock(long long initialMs, long long incrementMs) {
+    clock.configure(initialMs, incrementMs);
+}
+
+bool Game::chargeClock() {
+    if (clock.endTurn(currentTurn)) return true;
+    
+    Colour winner = (currentTurn == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    std::cout << (currentTurn == Colour::WHITE ? "White" : "Black") << " ran out of time! "
+              << (winner == Colour::WHITE ? "White" : "Black") << " wins!" << std::endl;
+    updateScore(winner);
+    gameInProgress = false;
+    return false;
+}
+
 
 void Game::resign() {
+    resign(currentTurn);
+}
+
+
+void Game::resign(Colour loser) {
     if (!gameInProgress) {
         std::cout << "No game in progress." << std::endl;
         return;
     }
     
-    Colour winner = (currentTurn == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    Colour winner = (loser == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
     updateScore(winner);
     
     std::string winnerStr = (winner == Colour::WHITE) ? "White" : "Black";
@@ -152,9 +214,10 @@ void Game::makePlayerMove(const Position& curr, const Position& dest, char promo
     }
 
     // Up until this point we were validating the move.
+    if (!chargeClock()) return;  // Flag fell before the move was made
     
     // Execute the move and does promotion if valid
-    board->makeMove(curr, dest, promotion); // Will make use of removePiece internally
+    board->makeMove(board->moveFor(curr, dest, promotion)); // Will make use of removePiece internally
     
     
     if (promotion != '\0') {
@@ -164,6 +227,7 @@ void Game::makePlayerMove(const Position& curr, const Position& dest, char promo
     
     // Check for game ending conditions
     switchTurn();
+    clock.startTurn();
     
     if (board->isInCheckmate(currentTurn)) { // Will check based of CurrentTurn's King
         Colour winner = (currentTurn == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
@@ -190,37 +254,84 @@ Player* Game::getCurrentPlayer() const {
 }
 
 
+void Game::analyse(SearchLimits limits, const SearchProgressCallback& report) {
+    if (!board) throw std::runtime_error("No position to analyse.");
+    Board analysisBoard(*board);
+    limits.threads = searchThreads;
+    Search search(transpositionTable.get(), evalCache.get(), network.get(), pawnTables.get());
+    search.setProgressCallback(report);
+    search.findBestMove(analysisBoard, limits);
+}
+
+
 void Game::makeComputerMove() {
+    playComputerMove(thinkComputerMove());
+}
+
+
+Move Game::thinkComputerMove(const std::atomic<bool>* stop, SearchProgressCallback progress) {
     if (!gameInProgress) {
         std::cout << "No game in progress." << std::endl;
-        return;
+        return Move();
     }
     
     Player* currentPlayer = getCurrentPlayer();
     if (!currentPlayer) {
         std::cout << "No current player available." << std::endl;
-        return;
+        return Move();
     }
 
-    // Get the computer's move choice
-    std::string moveStr = currentPlayer->getMove(*board);
-    
-    Position from(moveStr[1] - '0', moveStr[0] - 'a' + 1);
-    Position to(moveStr[3] - '0', moveStr[2] - 'a' + 1);
-    char promotion = (moveStr.length() == 5) ? moveStr[4] : '\0';
+    // Get the computer's move choice within its share of the clock
+    SearchLimits limits = clock.limitsFor(currentTurn);
+    limits.threads = searchThreads;
+    limits.stopSignal = stop;
+    currentPlayer->setSearchLimits(limits);
+    currentPlayer->setNetwork(network.get());
+    currentPlayer->setProgressCallback(std::move(progress));
+    return currentPlayer->getMove(*board);
+}
+
+
+void Game::preparePonder(Move expected, const std::atomic<bool>* stop, const std::atomic<bool>* ponder,
+                         SearchProgressCallback progress) {
+    Colour engine = (currentTurn == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+    ponderer = getPlayer(engine);
+    ponderBoard = std::make_unique<Board>(*board);
+    ponderBoard->doMove(expected);
+    
+    SearchLimits limits = clock.limitsFor(engine);
+    limits.threads = searchThreads;
+    limits.stopSignal = stop;
+    limits.ponder = ponder;
+    ponderer->setSearchLimits(limits);
+    ponderer->setNetwork(network.get());
+    ponderer->setProgressCallback(std::move(progress));
+}
+
+
+Move Game::ponderComputerMove() {
+    return ponderer->getMove(*ponderBoard);
+}
+
+
+void Game::playComputerMove(Move move) {
+    if (!gameInProgress) return;  // Already reported by thinkComputerMove
     
     // Validate and execute the move
-    if (!board->isValidMove(from, to, currentTurn)) {
+    if (move.isNull() || !board->isValidMove(toPosition(move.from()), toPosition(move.to()), currentTurn)) {
         std::cout << "Computer attempted invalid move!" << std::endl;
         return;
     }
     
+    if (!chargeClock()) return;  // Flag fell while thinking
+    
     // the move was already constructed by player functions.
-    board->makeMove(from, to, promotion);
-    std::cout << "Computer makes move: " << moveStr << std::endl;
+    board->makeMove(move);
+    std::cout << "Computer makes move: " << move.toString() << std::endl;
     
     // Check for game ending conditions
     switchTurn();
+    clock.startTurn();
     
     if (board->isInCheckmate(currentTurn)) {
         Colour winner = (currentTurn == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
@@ -293,6 +404,9 @@ void Game::setupRemovePiece(const Position& pos) {
 
 void Game::setupSetTurn(Colour colour) {
     currentTurn = colour;
+    if (board) {
+        board->setSideToMove(colour);  // Part of the position's hash key
+    }
     std::cout << "Set turn to " << (colour == Colour::WHITE ? "White" : "Black") << std::endl;
 }
 
@@ -306,7 +420,7 @@ bool Game::isValidSetup() {
     std::cout << "Validating setup..." << std::endl;
     
     // Check for exactly one king of each color
-    if (board->countPieces('K') != 1 || board->countPieces('k') != 1) {
+    if (board->pieceCount(Colour::WHITE, PieceType::KING) != 1 || board->pieceCount(Colour::BLACK, PieceType::KING) != 1) {
         std::cout << "Setup invalid: Must have exactly one white and one black king." << std::endl;
         return false;
     }
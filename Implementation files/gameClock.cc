@@ -0,0 +1,65 @@
+#include "gameClock.h"
+#include <algorithm>
+
+namespace {
+const long long SAFETY_MARGIN_MS = 50;  // Leaves room for move output and display updates
+const int EXPECTED_MOVES_LEFT = 40;     // Spread the remaining time as if this many moves are left
+const long long UNTIMED_SOFT_MS = 1000; // Budget per engine move when the game has no clock
+const long long UNTIMED_HARD_MS = 3000;
+
+int index(Colour colour) { return colour == Colour::WHITE ? 0 : 1; }
+}
+
+GameClock::GameClock() : enabled(false), remainingMs{0, 0}, incrementMs(0),
+                         turnStart(std::chrono::steady_clock::now()) {}
+
+void GameClock::configure(long long initialMs, long long increment) {
+    enabled = initialMs > 0;
+    remainingMs[0] = remainingMs[1] = initialMs;
+    incrementMs = increment;
+    startTurn();
+}
+
+void GameClock::startTurn() {
+    turnStart = std::chrono::steady_clock::now();
+}
+
+bool GameClock::endTurn(Colour colour) {
+    if (!enabled) return true;
+    
+    long long used = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - turnStart).count();
+    long long& remaining = remainingMs[index(colour)];
+    remaining -= used;
+    if (remaining <= 0) {
+        remaining = 0;
+        return false;
+    }
+    remaining += incrementMs;
+    return true;
+}
+
+long long GameClock::getRemainingMs(Colour colour) const {
+    return remainingMs[index(colour)];
+}
+
+SearchLimits GameClock::limitsFor(Colour colour) const {
+    SearchLimits limits;
+    if (!enabled) {
+        limits.softMs = UNTIMED_SOFT_MS;
+        limits.hardMs = UNTIMED_HARD_MS;
+        return limits;
+    }
+    
+    return budgetFor(remainingMs[index(colour)], incrementMs);
+}
+
+SearchLimits budgetFor(long long remainingMs, long long incrementMs, int movesToGo) {
+    SearchLimits limits;
+    long long remaining = std::max(1LL, remainingMs - SAFETY_MARGIN_MS);
+    int movesLeft = movesToGo > 0 ? std::min(movesToGo, EXPECTED_MOVES_LEFT) : EXPECTED_MOVES_LEFT;
+    limits.softMs = std::max(1LL, remaining / movesLeft + incrementMs * 3 / 4);
+    limits.hardMs = std::max(1LL, std::min(remaining / 4, limits.softMs * 4));
+    limits.softMs = std::min(limits.softMs, limits.hardMs);
+    return limits;
+}
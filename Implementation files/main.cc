@@ -1,8 +1,19 @@
+#include <string>
 #include "cmdInt.h"
+#include "uci.h"
+#include "attacks.h"
+
+int main(int argc, char* argv[]) {
+    initAttacks();  // Build the sliding attack tables once at startup
+
+    // ./chess --uci speaks the Universal Chess Interface, for GUIs and match managers
+    if (argc > 1 && std::string(argv[1]) == "--uci") {
+        UciEngine engine;
+        engine.run();
+        return 0;
+    }
 
-int main() {
     CommandInterpreter ci;
     ci.run();
     return 0;
 }
-
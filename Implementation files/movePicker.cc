@@ -0,0 +1,116 @@
+#include "movePicker.h"
+#include "board.h"
+#include "evaluation.h"
+#include <utility>
+
+namespace {
+// MVV-LVA: the victim's worth decides, the attacker (pawn cheapest, king dearest) breaks ties
+int captureScore(const Board& board, Move move) {
+    int victim = board.pieceIndexAt(move.to());
+    int score = (move.kind() == Move::EN_PASSANT) ? pieceWorth(PieceType::PAWN)
+              : victim != NO_PIECE ? pieceWorth(typeOfIndex(victim)) : 0;
+    if (move.isPromotion()) score += pieceWorth(move.promotion());
+    return score * 8 - static_cast<int>(typeOfIndex(board.pieceIndexAt(move.from())));
+}
+
+// Taking a piece worth at least the capturer can never lose material, so SEE is only needed for the rest
+bool losesMaterial(const Board& board, Move move) {
+    if (move.isPromotion() || move.kind() == Move::EN_PASSANT) return false;
+    PieceType attacker = typeOfIndex(board.pieceIndexAt(move.from()));
+    PieceType victim = typeOfIndex(board.pieceIndexAt(move.to()));
+    if (pieceValues[static_cast<int>(victim)] >= pieceValues[static_cast<int>(attacker)]) return false;
+    return board.see(move, pieceValues) < 0;
+}
+
+// Killers are only ever quiet moves, so one that would capture here belongs to another position
+bool isQuietHere(const Board& board, Move move) {
+    return (move.kind() == Move::NORMAL || move.kind() == Move::CASTLING) && board.pieceIndexAt(move.to()) == NO_PIECE;
+}
+}
+
+MovePicker::MovePicker(const Board& board, Move tableMove, Move killer1, Move killer2, const int (*history)[64])
+    : board(board), stage(TABLE_MOVE), capturesOnly(false), tableMove(tableMove),
+      killers{killer1, killer2}, killerIndex(0), history(history), current(0) {}
+
+MovePicker::MovePicker(const Board& board)
+    : board(board), stage(GENERATE_CAPTURES), capturesOnly(true),
+      killerIndex(0), history(nullptr), current(0) {}
+
+Move MovePicker::pickBest() {
+    size_t best = current;
+    for (size_t i = current + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    std::swap(moves[current], moves[best]);
+    std::swap(scores[current], scores[best]);
+    return moves[current++];
+}
+
+Move MovePicker::next() {
+    Colour us = board.getSideToMove();
+    switch (stage) {
+        case TABLE_MOVE:
+            stage = GENERATE_CAPTURES;
+            if (!tableMove.isNull() && board.isLegal(tableMove)) return tableMove;
+            [[fallthrough]];
+
+        case GENERATE_CAPTURES:
+            board.generateLegalCaptures(us, moves);
+            for (Move move : moves) scores.push_back(captureScore(board, move));
+            stage = CAPTURES;
+            [[fallthrough]];
+
+        case CAPTURES:
+            while (current < moves.size()) {
+                Move move = pickBest();
+                if (move == tableMove) continue;
+                if (losesMaterial(board, move)) {
+                    badCaptures.push_back(move);  // Tried after the quiet moves, or never in quiescence
+                    continue;
+                }
+                return move;
+            }
+            if (capturesOnly) {
+                stage = DONE;
+                return Move();
+            }
+            stage = KILLERS;
+            [[fallthrough]];
+
+        case KILLERS:
+            while (killerIndex < 2) {
+                Move& killer = killers[killerIndex++];
+                if (!killer.isNull() && killer != tableMove && isQuietHere(board, killer) && board.isLegal(killer)) return killer;
+                killer = Move();  // Not played here, so the quiet stage must not skip it
+            }
+            stage = GENERATE_QUIETS;
+            [[fallthrough]];
+
+        case GENERATE_QUIETS:
+            moves.clear();
+            scores.clear();
+            current = 0;
+            board.generateLegalQuiets(us, moves);
+            for (Move move : moves) scores.push_back(history ? history[move.from()][move.to()] : 0);
+            stage = QUIETS;
+            [[fallthrough]];
+
+        case QUIETS:
+            while (current < moves.size()) {
+                Move move = pickBest();
+                if (move != tableMove && move != killers[0] && move != killers[1]) return move;
+            }
+            current = 0;
+            stage = BAD_CAPTURES;
+            [[fallthrough]];
+
+        case BAD_CAPTURES:
+            if (current < badCaptures.size()) return badCaptures[current++];
+            stage = DONE;
+            [[fallthrough]];
+
+        case DONE:
+            break;
+    }
+    return Move();
+}
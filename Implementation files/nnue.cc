@@ -0,0 +1,331 @@
+#include "nnue.h"
+#include "board.h"
+#include "pieceSquareTables.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNUE_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+const int HIDDEN = NnueNetwork::HIDDEN;
+const char FILE_MAGIC[4] = {'C', 'N', 'N', '1'};
+
+// Accumulator kernels. update: dst = src + the added rows - the removed rows.
+// output: the clipped accumulators dotted with the output weights (side to move first).
+typedef void (*UpdateKernel)(const int16_t* src, int16_t* dst, const int16_t* const* added, int addCount,
+                             const int16_t* const* removed, int removeCount);
+typedef int32_t (*OutputKernel)(const int16_t* us, const int16_t* them, const int16_t* weights);
+
+struct Kernels {
+    const char* name;
+    UpdateKernel update;
+    OutputKernel output;
+};
+
+void updateScalar(const int16_t* src, int16_t* dst, const int16_t* const* added, int addCount,
+                  const int16_t* const* removed, int removeCount) {
+    for (int i = 0; i < HIDDEN; i++) {
+        int value = src[i];
+        for (int a = 0; a < addCount; a++) value += added[a][i];
+        for (int r = 0; r < removeCount; r++) value -= removed[r][i];
+        dst[i] = static_cast<int16_t>(value);
+    }
+}
+
+int32_t outputScalar(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    int32_t sum = 0;
+    for (int i = 0; i < HIDDEN; i++) {
+        sum += std::clamp<int>(us[i], 0, 127) * weights[i];
+        sum += std::clamp<int>(them[i], 0, 127) * weights[HIDDEN + i];
+    }
+    return sum;
+}
+
+#ifdef NNUE_X86
+__attribute__((target("avx2")))
+void updateAvx2(const int16_t* src, int16_t* dst, const int16_t* const* added, int addCount,
+                const int16_t* const* removed, int removeCount) {
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        for (int a = 0; a < addCount; a++) {
+            value = _mm256_add_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(added[a] + i)));
+        }
+        for (int r = 0; r < removeCount; r++) {
+            value = _mm256_sub_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(removed[r] + i)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), value);
+    }
+}
+
+__attribute__((target("avx2")))
+int32_t outputAvx2(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ceiling = _mm256_set1_epi16(127);
+    __m256i sum = zero;
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(us + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(them + i));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), ceiling);
+        b = _mm256_min_epi16(_mm256_max_epi16(b, zero), ceiling);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i))));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(b, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + HIDDEN + i))));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+
+__attribute__((target("sse4.1")))
+void updateSse41(const int16_t* src, int16_t* dst, const int16_t* const* added, int addCount,
+                 const int16_t* const* removed, int removeCount) {
+    for (int i = 0; i < HIDDEN; i += 8) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        for (int a = 0; a < addCount; a++) {
+            value = _mm_add_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(added[a] + i)));
+        }
+        for (int r = 0; r < removeCount; r++) {
+            value = _mm_sub_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(removed[r] + i)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+    }
+}
+
+__attribute__((target("sse4.1")))
+int32_t outputSse41(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ceiling = _mm_set1_epi16(127);
+    __m128i sum = zero;
+    for (int i = 0; i < HIDDEN; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(us + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(them + i));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), ceiling);
+        b = _mm_min_epi16(_mm_max_epi16(b, zero), ceiling);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i))));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(b, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + HIDDEN + i))));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+Kernels selectKernels() {
+#ifdef NNUE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {"AVX2", updateAvx2, outputAvx2};
+    if (__builtin_cpu_supports("sse4.1")) return {"SSE4.1", updateSse41, outputSse41};
+#endif
+    return {"scalar", updateScalar, outputScalar};
+}
+
+const Kernels& kernels() {
+    static const Kernels selected = selectKernels();  // Thread-safe, runs exactly once
+    return selected;
+}
+
+// Squares as side sees them: Black's are flipped so both sides play up the board
+int orient(int side, int square) { return side == 0 ? square : square ^ 56; }
+
+int featureIndex(int side, int kingSquare, int piece, int square) {
+    int kind = (piece < 6 ? 0 : 1) == side ? piece % 6 : 5 + piece % 6;  // Ours 0-4, theirs 5-9
+    return (orient(side, kingSquare) * 10 + kind) * 64 + orient(side, square);
+}
+
+Colour colourOfSide(int side) { return side == 0 ? Colour::WHITE : Colour::BLACK; }
+
+template <typename T>
+void readArray(std::ifstream& in, std::vector<T>& values) {
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+}
+
+NnueNetwork::NnueNetwork()
+    : featureBiases(HIDDEN), featureWeights(static_cast<size_t>(FEATURES) * HIDDEN),
+      outputWeights(2 * HIDDEN), outputBias(0) {
+    kernels();
+}
+
+const char* NnueNetwork::kernelName() {
+    return kernels().name;
+}
+
+// File layout (little-endian): "CNN1", FEATURES and HIDDEN as uint32, then the feature biases,
+// the feature weights row by row and the output weights as int16, and the output bias as int32
+std::unique_ptr<NnueNetwork> NnueNetwork::fromFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("Cannot open network file " + path);
+
+    char magic[4];
+    uint32_t features = 0, hidden = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(&features), sizeof(features));
+    in.read(reinterpret_cast<char*>(&hidden), sizeof(hidden));
+    if (!in || std::memcmp(magic, FILE_MAGIC, 4) != 0) throw std::runtime_error(path + " is not a network file");
+    if (features != FEATURES || hidden != HIDDEN) {
+        throw std::runtime_error(path + " has " + std::to_string(features) + "x" + std::to_string(hidden) +
+                                 " inputs, expected " + std::to_string(FEATURES) + "x" + std::to_string(HIDDEN));
+    }
+
+    std::unique_ptr<NnueNetwork> network(new NnueNetwork());
+    readArray(in, network->featureBiases);
+    readArray(in, network->featureWeights);
+    readArray(in, network->outputWeights);
+    in.read(reinterpret_cast<char*>(&network->outputBias), sizeof(network->outputBias));
+    if (!in) throw std::runtime_error(path + " is truncated");
+    network->source = path;
+    return network;
+}
+
+void NnueNetwork::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    uint32_t features = FEATURES, hidden = HIDDEN;
+    out.write(FILE_MAGIC, 4);
+    out.write(reinterpret_cast<const char*>(&features), sizeof(features));
+    out.write(reinterpret_cast<const char*>(&hidden), sizeof(hidden));
+    writeArray(out, featureBiases);
+    writeArray(out, featureWeights);
+    writeArray(out, outputWeights);
+    out.write(reinterpret_cast<const char*>(&outputBias), sizeof(outputBias));
+    if (!out) throw std::runtime_error("Cannot write network file " + path);
+}
+
+// Each piece's material and placement goes to one hidden unit, chosen by its kind and square,
+// in steps of 8 centipawns: 25 units a kind, so two pieces rarely share one and the 0..127 clip
+// (about 1000 centipawns) is hardly ever reached. The output adds our units
+// and subtracts theirs, half from each side's accumulator.
+std::unique_ptr<NnueNetwork> NnueNetwork::embedded() {
+    const int UNITS_PER_KIND = 25;
+    const int UNIT_CENTIPAWNS = 8;
+    const int OUTPUT_WEIGHT = OUTPUT_SCALE * UNIT_CENTIPAWNS / 2;
+    initPieceSquareTables();
+
+    std::unique_ptr<NnueNetwork> network(new NnueNetwork());
+    for (int kind = 0; kind < 10; kind++) {
+        bool ours = kind < 5;
+        int piece = ours ? kind : 6 + (kind - 5);  // Oriented squares read as if we were White
+        for (int square = 0; square < 64; square++) {
+            int value = (pieceSquare.mg[piece][square] + pieceSquare.eg[piece][square]) / 2;
+            if (!ours) value = -value;
+            int unit = kind * UNITS_PER_KIND + square % UNITS_PER_KIND;
+            for (int king = 0; king < 64; king++) {
+                int feature = (king * 10 + kind) * 64 + square;
+                network->featureWeights[static_cast<size_t>(feature) * HIDDEN + unit] =
+                    static_cast<int16_t>((value + UNIT_CENTIPAWNS / 2) / UNIT_CENTIPAWNS);
+            }
+        }
+        for (int i = 0; i < UNITS_PER_KIND; i++) {
+            int unit = kind * UNITS_PER_KIND + i;
+            network->outputWeights[unit] = static_cast<int16_t>(ours ? OUTPUT_WEIGHT : -OUTPUT_WEIGHT);
+            network->outputWeights[HIDDEN + unit] = static_cast<int16_t>(ours ? -OUTPUT_WEIGHT : OUTPUT_WEIGHT);
+        }
+    }
+    network->source = "embedded";
+    return network;
+}
+
+NnueAccumulators::NnueAccumulators(const NnueNetwork& network)
+    : network(network), entries(MAX_DEPTH + 1), top(0) {}
+
+void NnueAccumulators::reset() {
+    top = 0;
+    entries[0].computed[0] = entries[0].computed[1] = false;
+}
+
+void NnueAccumulators::push(const Board& board, Move move) {
+    Entry& entry = entries[++top];
+    entry.computed[0] = entry.computed[1] = false;
+    entry.kingMoved[0] = entry.kingMoved[1] = false;
+    entry.changes = 0;
+    auto change = [&entry](int piece, int from, int to) {
+        entry.piece[entry.changes] = static_cast<int8_t>(piece);
+        entry.from[entry.changes] = static_cast<int8_t>(from);
+        entry.to[entry.changes] = static_cast<int8_t>(to);
+        entry.changes++;
+    };
+
+    int from = move.from(), to = move.to();
+    int moved = board.pieceIndexAt(from);
+    int capturedSquare = (move.kind() == Move::EN_PASSANT) ? (from / 8) * 8 + to % 8 : to;
+    int captured = board.pieceIndexAt(capturedSquare);
+    if (captured != NO_PIECE && typeOfIndex(captured) != PieceType::KING) change(captured, capturedSquare, -1);
+
+    // Kings are not inputs: moving one just means its side's accumulator is rebuilt
+    if (typeOfIndex(moved) == PieceType::KING) {
+        entry.kingMoved[moved < 6 ? 0 : 1] = true;
+        if (move.kind() == Move::CASTLING) {
+            bool kingSide = to > from;
+            change(moved < 6 ? 3 : 9, kingSide ? from + 3 : from - 4, kingSide ? from + 1 : from - 1);  // The rook
+        }
+    } else if (move.isPromotion()) {
+        change(moved, from, -1);
+        change(pieceIndex(colourOfIndex(moved), move.promotion()), -1, to);
+    } else {
+        change(moved, from, to);
+    }
+}
+
+void NnueAccumulators::refresh(const Board& board, int side, Entry& entry) {
+    int king = std::max(board.kingSquare(colourOfSide(side)), 0);
+    const int16_t* rows[32];
+    int count = 0;
+    const int16_t* source = network.featureBiases.data();
+    Bitboard pieces = board.occupied() & ~board.pieces(Colour::WHITE, PieceType::KING) & ~board.pieces(Colour::BLACK, PieceType::KING);
+    while (pieces) {
+        int square = popLsb(pieces);
+        rows[count++] = network.row(featureIndex(side, king, board.pieceIndexAt(square), square));
+        if (count == 32 || !pieces) {
+            kernels().update(source, entry.values[side], rows, count, nullptr, 0);
+            source = entry.values[side];
+            count = 0;
+        }
+    }
+    if (source != entry.values[side]) std::copy(source, source + HIDDEN, entry.values[side]);  // No pieces at all
+    entry.computed[side] = true;
+}
+
+void NnueAccumulators::update(const Board& board, int side) {
+    // Find the nearest entry up the line that is computed, unless this side's king moved on the way
+    int computed = top;
+    while (!entries[computed].computed[side]) {
+        if (computed == 0 || entries[computed].kingMoved[side]) {
+            refresh(board, side, entries[top]);
+            return;
+        }
+        computed--;
+    }
+
+    // The king stood still since then, so every feature uses its square now
+    int king = board.kingSquare(colourOfSide(side));
+    for (int i = computed + 1; i <= top; i++) {
+        Entry& entry = entries[i];
+        const int16_t* added[3];
+        const int16_t* removed[3];
+        int addCount = 0, removeCount = 0;
+        for (int c = 0; c < entry.changes; c++) {
+            if (entry.from[c] >= 0) removed[removeCount++] = network.row(featureIndex(side, king, entry.piece[c], entry.from[c]));
+            if (entry.to[c] >= 0) added[addCount++] = network.row(featureIndex(side, king, entry.piece[c], entry.to[c]));
+        }
+        kernels().update(entries[i - 1].values[side], entry.values[side], added, addCount, removed, removeCount);
+        entry.computed[side] = true;
+    }
+}
+
+int NnueAccumulators::evaluate(const Board& board) {
+    update(board, 0);
+    update(board, 1);
+    int us = board.getSideToMove() == Colour::WHITE ? 0 : 1;
+    const Entry& entry = entries[top];
+    int32_t sum = kernels().output(entry.values[us], entry.values[1 - us], network.outputWeights.data()) + network.outputBias;
+    return sum / NnueNetwork::OUTPUT_SCALE;
+}
@@ -0,0 +1,103 @@
+#include "pawnTable.h"
+#include "board.h"
+#include "attacks.h"
+
+namespace {
+// Penalties and bonuses in centipawns, middlegame then endgame
+const int DOUBLED_MG = 10, DOUBLED_EG = 20;    // Per extra pawn on a file
+const int ISOLATED_MG = 10, ISOLATED_EG = 15;  // No pawns of ours on either neighbouring file
+const int BACKWARD_MG = 8, BACKWARD_EG = 10;   // Left behind its neighbours, and cannot advance safely
+const int passedMg[8] = {0, 5, 10, 15, 25, 40, 60, 0};    // By rank counted from the pawn's own side
+const int passedEg[8] = {0, 10, 20, 35, 60, 90, 130, 0};
+
+Bitboard fileBB(int file) { return FILE_A << file; }
+Bitboard adjacentFiles(int file) { return (file > 0 ? fileBB(file - 1) : 0) | (file < 7 ? fileBB(file + 1) : 0); }
+
+// Every square on the ranks in front of square, as colour's pawns advance
+Bitboard ranksAhead(Colour colour, int square) {
+    int rank = square / 8;
+    if (colour == Colour::WHITE) return rank == 7 ? 0 : ~Bitboard(0) << (8 * (rank + 1));
+    return (Bitboard(1) << (8 * rank)) - 1;
+}
+}
+
+PawnTable::PawnTable(int entryCount) : entries(entryCount), probes(0), hits(0) {}
+
+void PawnTable::clear() {
+    for (Entry& entry : entries) entry = Entry();
+}
+
+PawnTable& PawnTables::forThread(int thread) {
+    while (static_cast<int>(tables.size()) <= thread) tables.push_back(std::make_unique<PawnTable>());
+    return *tables[thread];
+}
+
+void PawnTables::clear() {
+    for (auto& table : tables) table->clear();
+}
+
+const PawnTable::Entry& PawnTable::probe(const Board& board) {
+    probes++;
+    Key key = board.getPawnKey();
+    Entry& entry = entries[key & (entries.size() - 1)];
+    if (entry.key == key) {
+        hits++;
+        return entry;
+    }
+    evaluatePawns(board, entry);
+    return entry;
+}
+
+void evaluatePawns(const Board& board, PawnTable::Entry& entry) {
+    entry.key = board.getPawnKey();
+    entry.mg = entry.eg = 0;
+    entry.passed = 0;
+
+    for (Colour colour : {Colour::WHITE, Colour::BLACK}) {
+        Colour enemy = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+        Bitboard ours = board.pieces(colour, PieceType::PAWN);
+        Bitboard theirs = board.pieces(enemy, PieceType::PAWN);
+        int up = (colour == Colour::WHITE) ? 8 : -8;
+        int mg = 0, eg = 0;
+
+        for (int file = 0; file < 8; file++) {
+            int count = popCount(ours & fileBB(file));
+            if (count > 1) {
+                mg -= DOUBLED_MG * (count - 1);
+                eg -= DOUBLED_EG * (count - 1);
+            }
+        }
+
+        Bitboard pawns = ours;
+        while (pawns) {
+            int square = popLsb(pawns);
+            int file = square % 8;
+            int rank = (colour == Colour::WHITE) ? square / 8 : 7 - square / 8;
+            Bitboard ahead = ranksAhead(colour, square);
+
+            // Passed: no enemy pawn can block or take it on the way, and it is the front pawn of its file
+            if (!(theirs & ahead & (fileBB(file) | adjacentFiles(file))) && !(ours & ahead & fileBB(file))) {
+                entry.passed |= squareBB(square);
+                mg += passedMg[rank];
+                eg += passedEg[rank];
+            }
+
+            if (!(ours & adjacentFiles(file))) {
+                mg -= ISOLATED_MG;
+                eg -= ISOLATED_EG;
+            } else if (rank < 7 && !(ours & adjacentFiles(file) & ~ahead) && (pawnAttacks(colour, square + up) & theirs)) {
+                // Every neighbour has gone past it, and an enemy pawn guards the square in front
+                mg -= BACKWARD_MG;
+                eg -= BACKWARD_EG;
+            }
+        }
+
+        if (colour == Colour::WHITE) {
+            entry.mg += mg;
+            entry.eg += eg;
+        } else {
+            entry.mg -= mg;
+            entry.eg -= eg;
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#include "perft.h"
+#include "board.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+long long elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+long long nodesPerSecond(long long nodes, long long ms) {
+    return ms > 0 ? nodes * 1000 / ms : nodes * 1000;
+}
+
+// Reference counts from the Chess Programming Wiki "Perft Results" page, depths 1 to 5
+struct PerftPosition {
+    const char* name;
+    const char* fen;
+    long long nodes[5];
+};
+
+const PerftPosition referencePositions[] = {
+    {"Start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+     {20, 400, 8902, 197281, 4865609}},
+    {"Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     {48, 2039, 97862, 4085603, 193690690}},
+    {"Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+     {14, 191, 2812, 43238, 674624}},
+    {"Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+     {6, 264, 9467, 422333, 15833292}},
+    {"Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+     {44, 1486, 62379, 2103487, 89941194}},
+    {"Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+     {46, 2079, 89890, 3894594, 164075551}},
+};
+}
+
+long long perft(Board& board, int depth) {
+    if (depth == 0) return 1;
+    
+    std::vector<Move> moves;
+    board.generateLegalMoves(board.getSideToMove(), moves);
+    if (depth == 1) return static_cast<long long>(moves.size());  // Leaves need no make/unmake
+    
+    long long nodes = 0;
+    for (Move move : moves) {
+        board.doMove(move);
+        nodes += perft(board, depth - 1);
+        board.undoMove();
+    }
+    return nodes;
+}
+
+void printPerft(Board& board, int depth) {
+    auto start = std::chrono::steady_clock::now();
+    long long nodes = perft(board, depth);
+    long long ms = elapsedMs(start);
+    std::cout << "perft " << depth << ": " << nodes << " nodes, " << ms << " ms ("
+              << nodesPerSecond(nodes, ms) << " nodes/sec)" << std::endl;
+}
+
+void divide(Board& board, int depth) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Move> moves;
+    board.generateLegalMoves(board.getSideToMove(), moves);
+    
+    long long total = 0;
+    for (Move move : moves) {
+        board.doMove(move);
+        long long nodes = depth > 1 ? perft(board, depth - 1) : 1;
+        board.undoMove();
+        std::cout << move.toString() << ": " << nodes << std::endl;
+        total += nodes;
+    }
+    
+    long long ms = elapsedMs(start);
+    std::cout << "Moves: " << moves.size() << ", nodes: " << total << ", time: " << ms << " ms ("
+              << nodesPerSecond(total, ms) << " nodes/sec)" << std::endl;
+}
+
+bool runPerftSuite(int maxDepth) {
+    bool allPassed = true;
+    long long totalNodes = 0, totalMs = 0;
+    
+    for (const PerftPosition& position : referencePositions) {
+        Board board;
+        board.setFen(position.fen);
+        std::cout << position.name << " (" << position.fen << ")" << std::endl;
+        
+        for (int depth = 1; depth <= maxDepth && depth <= 5; depth++) {
+            auto start = std::chrono::steady_clock::now();
+            long long nodes = perft(board, depth);
+            long long ms = elapsedMs(start);
+            totalNodes += nodes;
+            totalMs += ms;
+            
+            long long expected = position.nodes[depth - 1];
+            bool passed = nodes == expected;
+            if (!passed) allPassed = false;
+            std::cout << "  depth " << depth << ": " << nodes << " nodes, " << ms << " ms ("
+                      << nodesPerSecond(nodes, ms) << " nodes/sec) "
+                      << (passed ? "ok" : "WRONG, expected " + std::to_string(expected)) << std::endl;
+        }
+    }
+    
+    std::cout << "Total: " << totalNodes << " nodes in " << totalMs << " ms ("
+              << nodesPerSecond(totalNodes, totalMs) << " nodes/sec)" << std::endl;
+    std::cout << (allPassed ? "All perft counts match." : "Some perft counts are WRONG.") << std::endl;
+    return allPassed;
+}
@@ -0,0 +1,17 @@
+#include "perft.h"
+#include "attacks.h"
+#include <cstdlib>
+#include <iostream>
+
+// Standalone move generator benchmark: ./perft [depth]
+// Exits non-zero if any reference count is wrong, so it can be run after every movegen change.
+int main(int argc, char* argv[]) {
+    int depth = (argc > 1) ? std::atoi(argv[1]) : 4;
+    if (depth < 1) {
+        std::cerr << "Usage: " << argv[0] << " [depth]" << std::endl;
+        return 2;
+    }
+    
+    initAttacks();
+    return runPerftSuite(depth) ? 0 : 1;
+}
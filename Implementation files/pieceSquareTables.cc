@@ -0,0 +1,130 @@
+#include "pieceSquareTables.h"
+
+const int pieceValues[6] = {100, 320, 330, 500, 900, 0};
+
+PieceSquareTables pieceSquare;
+
+namespace {
+// Piece-square tables written from White's side with rank 8 on the first line,
+// the way a board diagram reads. Black uses the same tables mirrored.
+// Knights, bishops, rooks and queens use one table for both phases.
+const int pawnTable[64] = {
+     0,  0,  0,  0,  0,  0,  0,  0,
+    50, 50, 50, 50, 50, 50, 50, 50,
+    10, 10, 20, 30, 30, 20, 10, 10,
+     5,  5, 10, 25, 25, 10,  5,  5,
+     0,  0,  0, 20, 20,  0,  0,  0,
+     5, -5,-10,  0,  0,-10, -5,  5,
+     5, 10, 10,-20,-20, 10, 10,  5,
+     0,  0,  0,  0,  0,  0,  0,  0
+};
+
+const int knightTable[64] = {
+    -50,-40,-30,-30,-30,-30,-40,-50,
+    -40,-20,  0,  0,  0,  0,-20,-40,
+    -30,  0, 10, 15, 15, 10,  0,-30,
+    -30,  5, 15, 20, 20, 15,  5,-30,
+    -30,  0, 15, 20, 20, 15,  0,-30,
+    -30,  5, 10, 15, 15, 10,  5,-30,
+    -40,-20,  0,  5,  5,  0,-20,-40,
+    -50,-40,-30,-30,-30,-30,-40,-50
+};
+
+const int bishopTable[64] = {
+    -20,-10,-10,-10,-10,-10,-10,-20,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -10,  0,  5, 10, 10,  5,  0,-10,
+    -10,  5,  5, 10, 10,  5,  5,-10,
+    -10,  0, 10, 10, 10, 10,  0,-10,
+    -10, 10, 10, 10, 10, 10, 10,-10,
+    -10,  5,  0,  0,  0,  0,  5,-10,
+    -20,-10,-10,-10,-10,-10,-10,-20
+};
+
+const int rookTable[64] = {
+      0,  0,  0,  0,  0,  0,  0,  0,
+      5, 10, 10, 10, 10, 10, 10,  5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+      0,  0,  0,  5,  5,  0,  0,  0
+};
+
+const int queenTable[64] = {
+    -20,-10,-10, -5, -5,-10,-10,-20,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+     -5,  0,  5,  5,  5,  5,  0, -5,
+      0,  0,  5,  5,  5,  5,  0, -5,
+    -10,  5,  5,  5,  5,  5,  0,-10,
+    -10,  0,  5,  0,  0,  0,  0,-10,
+    -20,-10,-10, -5, -5,-10,-10,-20
+};
+
+const int kingTable[64] = {
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -20,-30,-30,-40,-40,-30,-30,-20,
+    -10,-20,-20,-20,-20,-20,-20,-10,
+     20, 20,  0,  0,  0,  0, 20, 20,
+     20, 30, 10,  0,  0, 10, 30, 20
+};
+
+// In the endgame passed pawns matter more the further they have come, and the king
+// belongs in the centre rather than behind its pawns
+const int pawnEndgameTable[64] = {
+     0,  0,  0,  0,  0,  0,  0,  0,
+    80, 80, 80, 80, 80, 80, 80, 80,
+    50, 50, 50, 50, 50, 50, 50, 50,
+    30, 30, 30, 30, 30, 30, 30, 30,
+    15, 15, 15, 15, 15, 15, 15, 15,
+     5,  5,  5,  5,  5,  5,  5,  5,
+     0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0
+};
+
+const int kingEndgameTable[64] = {
+    -50,-40,-30,-20,-20,-30,-40,-50,
+    -30,-20,-10,  0,  0,-10,-20,-30,
+    -30,-10, 20, 30, 30, 20,-10,-30,
+    -30,-10, 30, 40, 40, 30,-10,-30,
+    -30,-10, 30, 40, 40, 30,-10,-30,
+    -30,-10, 20, 30, 30, 20,-10,-30,
+    -30,-30,  0,  0,  0,  0,-30,-30,
+    -50,-30,-30,-30,-30,-30,-30,-50
+};
+
+const int* const middlegameTables[6] = {
+    pawnTable, knightTable, bishopTable, rookTable, queenTable, kingTable
+};
+
+const int* const endgameTables[6] = {
+    pawnEndgameTable, knightTable, bishopTable, rookTable, queenTable, kingEndgameTable
+};
+
+const int endgameValues[6] = {120, 300, 320, 520, 940, 0};
+
+bool buildPieceSquareTables() {
+    for (int type = 0; type < 6; type++) {
+        for (int square = 0; square < 64; square++) {
+            // White reads the diagram-ordered tables with the rank flipped, Black as written
+            int white = pieceIndex(Colour::WHITE, static_cast<PieceType>(type));
+            int black = pieceIndex(Colour::BLACK, static_cast<PieceType>(type));
+            pieceSquare.mg[white][square] = pieceValues[type] + middlegameTables[type][square ^ 56];
+            pieceSquare.eg[white][square] = endgameValues[type] + endgameTables[type][square ^ 56];
+            pieceSquare.mg[black][square] = -(pieceValues[type] + middlegameTables[type][square]);
+            pieceSquare.eg[black][square] = -(endgameValues[type] + endgameTables[type][square]);
+        }
+    }
+    return true;
+}
+}
+
+void initPieceSquareTables() {
+    static const bool built = buildPieceSquareTables();  // Thread-safe, runs exactly once
+    (void)built;
+}
@@ -1,6 +1,8 @@
 #include "player.h"
 #include "board.h"
 #include "piece.h"
+#include "search.h"
+#include "transpositionTable.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -8,6 +10,7 @@
 #include <ctime>
 #include <algorithm>
 #include <stdexcept>
+#include <iomanip>
 
 // Forward declaration - will be implemented later
 class Board;
@@ -22,180 +25,62 @@ Player::Player(Colour colour) : colour(colour) {
     }
 }
 
-std::string Player::positionToString(const Position& pos) const {
-    char col = 'a' + (pos.getCol() - 1); // Makem it index form, then convert to string
-    char row = '0' + pos.getRow(); 
-    return std::string(1, col) + std::string(1, row); // Makes the char's become strings, by constructing one char each time then adding them 
-}
-
 // Helper method to get piece values for AI decision making
-int Player::getPieceValue(const std::string& pieceType) const {
-    if (pieceType == "Queen") return 9;
-    if (pieceType == "Rook") return 5;
-    if (pieceType == "Bishop") return 3;
-    if (pieceType == "Knight") return 2;  // Some consider Knight = 3, others = 2.5
-    if (pieceType == "Pawn") return 1;
-    if (pieceType == "King") return 0;   // King is invaluable, not captured in normal play
-    return 0;  // Unknown piece type
+int Player::getPieceValue(PieceType type) const {
+    return pieceWorth(type);  // Shared with the search's capture ordering
 }
 
-std::vector<std::string> Player::getAllLegalMoves(const Board& board) const {
-    std::vector<std::string> legalMoves;
-    
-    // Iterate through all squares to find pieces of our color
-    for (int row = 1; row <= 8; row++) {
-        for (int col = 1; col <= 8; col++) {
-            Position from(row, col);
-            Piece* piece = board.getPiece(from);
-            
-            if (piece && piece->getColour() == colour) {
-                // Get all possible moves for the current colour
-                std::vector<Position> possibleMoves = piece->getPossibleMoves(from, board); 
-                // contains all the moves we can play for the current piece
-                
-                for (const Position& to : possibleMoves) {
-                    // Check if this move is legal (doesn't put own king in check)
-                    if (board.isValidMove(from, to, colour) && !board.wouldBeInCheck(from, to, colour)) {
-                        // Check if this is a pawn promotion move
-                        if (piece->getType() == "Pawn") {
-                            // Cast to Pawn to access isPromotionRank method
-                            Pawn* pawn = static_cast<Pawn*>(piece);
-                            if (pawn->isPromotionRank(to)) {
-                                // Generate all four promotion options
-                                std::string baseMove = positionToString(from) + positionToString(to);
-                                legalMoves.push_back(baseMove + "Q"); // Promote to Queen
-                                legalMoves.push_back(baseMove + "R"); // Promote to Rook
-                                legalMoves.push_back(baseMove + "B"); // Promote to Bishop
-                                legalMoves.push_back(baseMove + "N"); // Promote to Knight
-                            } else {
-                                // Regular pawn move (not promotion)
-                                std::string moveStr = positionToString(from) + positionToString(to);
-                                legalMoves.push_back(moveStr);
-                            }
-                        } else {
-                            // Non-pawn move
-                            std::string moveStr = positionToString(from) + positionToString(to);
-                            legalMoves.push_back(moveStr);
-                        }
-                    }
-                }
-            }
-        }
-    }
-    
+std::vector<Move> Player::getAllLegalMoves(const Board& board) const {
+    // Every move for our colour that doesn't leave our own king in check; promotions come as all four pieces
+    std::vector<Move> legalMoves;
+    board.generateLegalMoves(colour, legalMoves);
     return legalMoves;
 }
 
 
 
 // Helper method to check if a move puts enemy king in check
-bool Player::putsEnemyInCheck(const std::string& move, const Board& board) const {
-    Position from(move[1] - '0', move[0] - 'a' + 1);
-    Position to(move[3] - '0', move[2] - 'a' + 1);
-    
-    // Get the enemy color
-    Colour enemyColour = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
-    
+bool Player::putsEnemyInCheck(Move move, const Board& board) const {
     // Use the board's wouldBeInCheck logic but check enemy king instead
-    // Since we're a friend class, we can access the private implementation
-    Piece* movingPiece = board.getPiece(from);
-    if (!movingPiece) return false;
-    
-    // Clone the captured piece BEFORE making the move
-    std::unique_ptr<Piece> capturedPieceClone = nullptr;
-    Piece* capturedPiece = board.getPiece(to);
-    if (capturedPiece) {
-        capturedPieceClone = capturedPiece->clone();
-    }
-    
-    // Temporarily make the move using friend access
-    Board& nonConstBoard = const_cast<Board&>(board);
-    nonConstBoard.grid[to.getRow() - 1][to.getCol() - 1] = std::move(nonConstBoard.grid[from.getRow() - 1][from.getCol() - 1]);
-    nonConstBoard.grid[from.getRow() - 1][from.getCol() - 1] = nullptr;
-    
-    // Check if enemy king is in check (this is what we want to know)
-    bool enemyInCheck = board.isInCheck(enemyColour);
-    
-    // Restore the board
-    nonConstBoard.grid[from.getRow() - 1][from.getCol() - 1] = std::move(nonConstBoard.grid[to.getRow() - 1][to.getCol() - 1]);
-    if (capturedPieceClone) {
-        nonConstBoard.grid[to.getRow() - 1][to.getCol() - 1] = std::move(capturedPieceClone);
-    } else {
-        nonConstBoard.grid[to.getRow() - 1][to.getCol() - 1] = nullptr;
-    }
+    if (board.pieceIndexAt(move.from()) == NO_PIECE) return false;
     
-    return enemyInCheck;
+    // The board answers from its bitboards without making the move, so this is safe on a shared board
+    return board.givesCheck(move);
 }
 
 // Helper method to check if a move avoids being captured
-bool Player::avoidsCapture(const std::string& move, const Board& board) const {
-    Position from(move[1] - '0', move[0] - 'a' + 1);
-    Position to(move[3] - '0', move[2] - 'a' + 1);
-    
-    // Check if the piece at 'from' is currently under attack
-    Piece* ourPiece = board.getPiece(from);
-    if (!ourPiece) return false;
-    
-    // Check if any enemy piece can capture our piece at the 'from' position
-    Colour enemyColour = (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
-    bool currentlyUnderAttack = false;
-    
-    // Check if any enemy piece can attack the 'from' position
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (board.grid[row][col] && board.grid[row][col]->getColour() == enemyColour) {
-                // Just found an enemy piece to check if it can attack us
-                Position enemyPos(row + 1, col + 1);  // Convert to 1-indexed
-                if (board.grid[row][col]->isValidMove(enemyPos, from, board)) { // We are under attack
-                    currentlyUnderAttack = true;
-                    break;
-                }
-            }
-        }
-        if (currentlyUnderAttack) break;
-    }
+bool Player::avoidsCapture(Move move, const Board& board) const {
+    // Check if the piece at 'from' is currently in danger: attacked, and the enemy comes out
+    // ahead of the exchange (a defended piece attacked by something bigger is not in danger)
+    if (board.pieceIndexAt(move.from()) == NO_PIECE) return false;
+    bool currentlyInDanger = board.threatenedLoss(move.from(), PIECE_WORTH) > 0;
     
-    // If not currently under attack, this move doesn't avoid capture
-    if (!currentlyUnderAttack) return false;
+    // If not currently in danger, this move doesn't avoid capture
+    if (!currentlyInDanger) return false;
     // We only do everything beneath if we are currently in danger. 
 
-    // Check if moving to 'to' position puts us out of danger
-    bool wouldBeUnderAttack = false;
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            if (board.grid[row][col] && board.grid[row][col]->getColour() == enemyColour) {
-                Position enemyPos(row + 1, col + 1);  // Convert to 1-indexed
-                if (board.grid[row][col]->isValidMove(enemyPos, to, board)) {
-                    wouldBeUnderAttack = true;
-                    break;
-                }
-            }
-        }
-        if (wouldBeUnderAttack) break;
-    }
-    
-    // Return true if we're currently under attack but wouldn't be after the move
-    return currentlyUnderAttack && !wouldBeUnderAttack;
+    // Check the new square is safe too: whatever the enemy can take there, we don't lose on the exchange
+    return board.see(move, PIECE_WORTH) >= 0;
 }
 
 // HumanPlayer implementation
 HumanPlayer::HumanPlayer(Colour colour) : Player(colour) {}
 
-std::string HumanPlayer::getMove(const Board& board) {
+Move HumanPlayer::getMove(const Board& board) {
     // Human moves are handled through the command interpreter
     // This function should never be called in normal gameplay
     std::cerr << "Warning: HumanPlayer::getMove called - human input should be handled by command interpreter" << std::endl;
-    return "a1a1";  // Dummy return to satisfy linker
+    return Move();  // Null move (a1a1), to satisfy linker
 }
 
 // ComputerPlayer1 implementation (Level 1 - Basic)
 ComputerPlayer1::ComputerPlayer1(Colour colour) : Player(colour) {}
 
-std::string ComputerPlayer1::getMove(const Board& board) {
+Move ComputerPlayer1::getMove(const Board& board) {
     // Level 1: Random legal moves
     std::cout << "Computer Level 1 (" << (colour == Colour::WHITE ? "White" : "Black") << ") is thinking..." << std::endl;
     
-    std::vector<std::string> legalMoves = getAllLegalMoves(board); // Promotions are in here already 
+    std::vector<Move> legalMoves = getAllLegalMoves(board); // Promotions are in here already 
     // If no legal moves, let the game handle stalemate/checkmate detection
     
     // Return a random legal move
@@ -206,26 +91,23 @@ std::string ComputerPlayer1::getMove(const Board& board) {
 // ComputerPlayer2 implementation (Level 2 - Intermediate)
 ComputerPlayer2::ComputerPlayer2(Colour colour) : Player(colour) {}
 
-std::string ComputerPlayer2::getMove(const Board& board) {
+Move ComputerPlayer2::getMove(const Board& board) {
     // Level 2: Prefers moves that capture enemy pieces OR put enemy king in check
     std::cout << "Computer Level 2 (" << (colour == Colour::WHITE ? "White" : "Black") << ") is thinking..." << std::endl;
     
-    std::vector<std::string> legalMoves = getAllLegalMoves(board);
+    std::vector<Move> legalMoves = getAllLegalMoves(board);
     // If no legal moves, let the game handle stalemate/checkmate detection
     
-    std::vector<std::string> filteredMoves;
+    std::vector<Move> filteredMoves;
     
     // Find moves that capture enemy pieces OR put enemy king in check
-    for (const std::string& move : legalMoves) {
-        Position from(move[1] - '0', move[0] - 'a' + 1);
-        Position to(move[3] - '0', move[2] - 'a' + 1);
-        
+    for (Move move : legalMoves) {
         bool isCapture = false;
         bool putsInCheck = false;
         
         // Check if it's a capturing move
-        Piece* targetPiece = board.getPiece(to);
-        if (targetPiece && targetPiece->getColour() != colour) {
+        int target = board.pieceIndexAt(move.to());
+        if (target != NO_PIECE && colourOfIndex(target) != colour) {
             isCapture = true;
         }
         
@@ -253,27 +135,24 @@ std::string ComputerPlayer2::getMove(const Board& board) {
 // ComputerPlayer3 implementation (Level 3 - Advanced)
 ComputerPlayer3::ComputerPlayer3(Colour colour) : Player(colour) {}
 
-std::string ComputerPlayer3::getMove(const Board& board) {
+Move ComputerPlayer3::getMove(const Board& board) {
     // Level 3: Prefers moves that capture enemy pieces OR put enemy king in check OR avoid being captured
     std::cout << "Computer Level 3 (" << (colour == Colour::WHITE ? "White" : "Black") << ") is thinking..." << std::endl;
     
-    std::vector<std::string> legalMoves = getAllLegalMoves(board);
+    std::vector<Move> legalMoves = getAllLegalMoves(board);
     // If no legal moves, let the game handle stalemate/checkmate detection
     
-    std::vector<std::string> filteredMoves;
+    std::vector<Move> filteredMoves;
     
     // Find moves that capture enemy pieces OR put enemy king in check OR avoid being captured
-    for (const std::string& move : legalMoves) {
-        Position from(move[1] - '0', move[0] - 'a' + 1);
-        Position to(move[3] - '0', move[2] - 'a' + 1);
-        
+    for (Move move : legalMoves) {
         bool isCapture = false;
         bool putsInCheck = false;
         bool avoidsBeingCaptured = false;
         
-        // Check if it's a capturing move
-        Piece* targetPiece = board.getPiece(to);
-        if (targetPiece && targetPiece->getColour() != colour) {
+        // Check if it's a capturing move that doesn't lose material once the recaptures are played out
+        int target = board.pieceIndexAt(move.to());
+        if (target != NO_PIECE && colourOfIndex(target) != colour && board.see(move, PIECE_WORTH) >= 0) {
             isCapture = true;
         }
         
@@ -306,37 +185,36 @@ std::string ComputerPlayer3::getMove(const Board& board) {
 // ComputerPlayer4 implementation (Level 4 - Expert)
 ComputerPlayer4::ComputerPlayer4(Colour colour) : Player(colour) {}
 
-std::string ComputerPlayer4::getMove(const Board& board) {
+Move ComputerPlayer4::getMove(const Board& board) {
     // Level 4: Priority system - Check > Capture > Avoid Capture > Random
     std::cout << "Computer Level 4 (" << (colour == Colour::WHITE ? "White" : "Black") << ") is thinking..." << std::endl;
     
-    std::vector<std::string> legalMoves = getAllLegalMoves(board);
+    std::vector<Move> legalMoves = getAllLegalMoves(board);
     // If no legal moves, let the game handle stalemate/checkmate detection
     
-    std::vector<std::string> checkMoves;
-    std::vector<std::string> capturingMoves;
-    std::vector<std::string> avoidCaptureMoves;
+    std::vector<Move> checkMoves;
+    std::vector<Move> capturingMoves;
+    std::vector<Move> avoidCaptureMoves;
     
     // Tracker variables for highest value pieces
     int highestCaptureValue = 0;
     int highestAvoidValue = 0;
     
     // Categorize all moves and track highest values
-    for (const std::string& move : legalMoves) {
-        Position from(move[1] - '0', move[0] - 'a' + 1);
-        Position to(move[3] - '0', move[2] - 'a' + 1);
-        
+    for (Move move : legalMoves) {
         // Check for check moves
         if (putsEnemyInCheck(move, board)) {
             checkMoves.push_back(move);
         }
         
-        // Check for capturing moves and track highest value (store only first highest)
-        Piece* targetPiece = board.getPiece(to);
-        if (targetPiece && targetPiece->getColour() != colour) {
-            int enemyPieceValue = getPieceValue(targetPiece->getType());
-            if (enemyPieceValue > highestCaptureValue) {
-                highestCaptureValue = enemyPieceValue;
+        // Check for capturing moves and track highest value (store only first highest).
+        // The value is what the capture actually wins after the recaptures, so a defended piece
+        // taken by something bigger is worth nothing (or less)
+        int target = board.pieceIndexAt(move.to());
+        if (target != NO_PIECE && colourOfIndex(target) != colour) {
+            int captureGain = board.see(move, PIECE_WORTH);
+            if (captureGain > highestCaptureValue) {
+                highestCaptureValue = captureGain;
                 capturingMoves.clear();  // Clear previous lower value moves
                 capturingMoves.push_back(move);  // Store only the first highest value move
             }
@@ -345,8 +223,7 @@ std::string ComputerPlayer4::getMove(const Board& board) {
         
         // Check for avoid capture moves and track highest value (store only first highest)
         if (avoidsCapture(move, board)) {
-            Piece* ourPiece = board.getPiece(from);
-            int ourPieceValue = ourPiece ? getPieceValue(ourPiece->getType()) : 0;
+            int ourPieceValue = board.threatenedLoss(move.from(), PIECE_WORTH);  // What staying put would lose
             if (ourPieceValue > highestAvoidValue) {
                 highestAvoidValue = ourPieceValue;
                 avoidCaptureMoves.clear();  // Clear previous lower value moves
@@ -383,6 +260,48 @@ std::string ComputerPlayer4::getMove(const Board& board) {
     return legalMoves[randomIndex];
 }
 
+// ComputerPlayer5 implementation (Level 5 - Search)
+ComputerPlayer5::ComputerPlayer5(Colour colour, TranspositionTable* table, EvalCache* evalCache, PawnTables* pawnTables)
+    : Player(colour), table(table), evalCache(evalCache), pawnTables(pawnTables), network(nullptr) {
+    limits.maxDepth = 5;  // Bounded even if nobody hands us a time budget
+}
+
+Move ComputerPlayer5::getMove(const Board& board) {
+    // Level 5: Alpha-beta search, deepening one ply at a time until the time budget runs out,
+    // scoring leaves by material and piece placement
+    std::cout << "Computer Level 5 (" << (colour == Colour::WHITE ? "White" : "Black") << ") is thinking..." << std::endl;
+    
+    // Search on a private copy so the game board (and its displays) are never touched
+    Board searchBoard = board;
+    Search search(table, evalCache, network, pawnTables);
+    search.setProgressCallback(progressCallback);
+    Move bestMove = search.findBestMove(searchBoard, limits);
+    
+    std::cout << "Searched " << search.getNodes() << " nodes to depth " << search.getCompletedDepth()
+              << " in " << search.getElapsedMs() << " ms ("
+              << search.getNodesPerSecond() << " nodes/sec";
+    if (limits.threads > 1) std::cout << " on " << limits.threads << " threads";
+    std::cout << ")" << std::endl;
+    if (table) {
+        std::cout << "Transposition table: " << table->getSizeMB() << " MB, "
+                  << std::fixed << std::setprecision(1) << search.getTableHitRate() << std::defaultfloat
+                  << "% hit rate" << std::endl;
+    }
+    if (evalCache) {
+        std::cout << "Eval cache: " << evalCache->getSizeMB() << " MB, "
+                  << std::fixed << std::setprecision(1) << search.getEvalCacheHitRate() << std::defaultfloat
+                  << "% hit rate" << std::endl;
+    }
+    if (network) {
+        std::cout << "NNUE (" << network->getSource() << ", " << NnueNetwork::kernelName() << "): "
+                  << search.getEvaluationsPerSecond() << " evals/sec" << std::endl;
+    } else {
+        std::cout << "Pawn table: " << std::fixed << std::setprecision(1) << search.getPawnTableHitRate()
+                  << std::defaultfloat << "% hit rate, " << search.getEvaluationsPerSecond() << " evals/sec" << std::endl;
+    }
+    return bestMove;
+}
+
 
 
 // If we wanna strengthen any of these AI's, simply strengthen the filtering criteria of the vectors they randomly chppse from
@@ -18,14 +18,16 @@ int PlayerFactory::extractComputerLevel(const std::string& playerType) {
   
   // Extract the last character (the level)
   char levelChar = playerType[8];
-  if (levelChar >= '1' && levelChar <= '4') {
+  if (levelChar >= '1' && levelChar <= '5') {
       return levelChar - '0'; // Convert char to int
   }
   
   return -1; // Invalid format
 } 
 
-std::unique_ptr<Player> PlayerFactory::createPlayer(const std::string& playerType, Colour colour) {
+std::unique_ptr<Player> PlayerFactory::createPlayer(const std::string& playerType, Colour colour,
+                                                    TranspositionTable* table, EvalCache* evalCache,
+                                                    PawnTables* pawnTables) {
     // Manual case-insensitive comparison for "human"
     if (playerType == "human" || playerType == "Human" || playerType == "HUMAN") {
         return std::make_unique<HumanPlayer>(colour);
@@ -43,6 +45,8 @@ std::unique_ptr<Player> PlayerFactory::createPlayer(const std::string& playerTyp
                 return std::make_unique<ComputerPlayer3>(colour);
             case 4:
                 return std::make_unique<ComputerPlayer4>(colour);
+            case 5:
+                return std::make_unique<ComputerPlayer5>(colour, table, evalCache, pawnTables);
             default:
                 throw std::invalid_argument("Invalid computer level");
         }
@@ -0,0 +1,407 @@
+#include "search.h"
+#include "board.h"
+#include "evaluation.h"
+#include "transpositionTable.h"
+#include "movePicker.h"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <memory>
+#include <thread>
+
+namespace {
+// Mate scores are stored relative to the node rather than the root, so they stay
+// correct when the same position is reached at a different ply
+int scoreToTable(int score, int ply) {
+    if (score > MATE_SCORE - 1000) return score + ply;
+    if (score < -MATE_SCORE + 1000) return score - ply;
+    return score;
+}
+
+int scoreFromTable(int score, int ply) {
+    if (score > MATE_SCORE - 1000) return score - ply;
+    if (score < -MATE_SCORE + 1000) return score + ply;
+    return score;
+}
+
+// Moves the table's best move to the front so it is searched first
+void putTableMoveFirst(std::vector<Move>& moves, uint16_t tableMove) {
+    if (tableMove == 0) return;
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (moves[i].raw() == tableMove) {
+            std::swap(moves[0], moves[i]);
+            return;
+        }
+    }
+}
+}
+
+Search::Search(TranspositionTable* table, EvalCache* evalCache, const NnueNetwork* network, PawnTables* pawnTables)
+    : table(table), evalCache(evalCache), network(network),
+      accumulators(network ? std::make_unique<NnueAccumulators>(*network) : nullptr), stopRequested(false), stop(&stopRequested), isMainThread(true), nodes(0),
+      tableProbes(0), tableHits(0), pawnTables(pawnTables), pawnTable(nullptr), pawnProbes(0), pawnHits(0), evalProbes(0), evalHits(0), evaluations(0), elapsedMs(0), completedDepth(0), bestScore(0) {}
+
+long long Search::getNodesPerSecond() const {
+    return elapsedMs > 0 ? nodes * 1000 / elapsedMs : nodes * 1000;
+}
+
+double Search::getTableHitRate() const {
+    return tableProbes > 0 ? 100.0 * tableHits / tableProbes : 0.0;
+}
+
+double Search::getPawnTableHitRate() const {
+    return pawnProbes > 0 ? 100.0 * pawnHits / pawnProbes : 0.0;
+}
+
+double Search::getEvalCacheHitRate() const {
+    return evalProbes > 0 ? 100.0 * evalHits / evalProbes : 0.0;
+}
+
+long long Search::getEvaluationsPerSecond() const {
+    return elapsedMs > 0 ? evaluations * 1000 / elapsedMs : evaluations * 1000;
+}
+
+int Search::staticEval(const Board& board) {
+    int score;
+    if (evalCache) {
+        evalProbes++;
+        if (evalCache->probe(board.getKey(), score)) {
+            evalHits++;
+            return score;
+        }
+    }
+    evaluations++;
+    score = accumulators ? accumulators->evaluate(board) : evaluate(board, pawnTable);
+    if (evalCache) evalCache->store(board.getKey(), score);
+    return score;
+}
+
+void Search::playMove(Board& board, Move move) {
+    if (accumulators) accumulators->push(board, move);
+    board.doMove(move);
+}
+
+void Search::takeBack(Board& board) {
+    board.undoMove();
+    if (accumulators) accumulators->pop();
+}
+
+bool Search::probeTable(Key key, TranspositionTable::Entry& entry) {
+    if (!table) return false;
+    tableProbes++;
+    bool hit = table->probe(key, entry);
+    if (hit) tableHits++;
+    return hit;
+}
+
+bool Search::pondering() {
+    if (!limits.ponder) return false;
+    if (limits.ponder->load()) return true;
+    limits.ponder = nullptr;  // Ponder hit: the position is real now, and the time budget starts
+    budgetStart = std::chrono::steady_clock::now();
+    return false;
+}
+
+long long Search::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+}
+
+long long Search::budgetElapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - budgetStart).count();
+}
+
+void Search::checkTime() {
+    // Depth 1 always finishes so there is a move to play
+    if (completedDepth == 0) return;
+    if (limits.stopSignal && limits.stopSignal->load(std::memory_order_relaxed)) stopRequested = true;
+    if (pondering()) return;
+    if (limits.hardMs > 0 && budgetElapsed() >= limits.hardMs) stopRequested = true;
+    if (limits.maxNodes > 0 && nodes >= limits.maxNodes) stopRequested = true;
+}
+
+int Search::quiesce(Board& board, int alpha, int beta, int ply) {
+    nodes++;
+    if (isMainThread && nodes % NODES_BETWEEN_TIME_CHECKS == 0) checkTime();
+    if (stopped()) return 0;  // Result is thrown away
+    
+    bool inCheck = board.isInCheck(board.getSideToMove());
+    int best = -INFINITE_SCORE;
+    if (!inCheck) {
+        // Stand pat: the side to move need not capture, so the static score is a lower bound
+        best = staticEval(board);
+        if (best >= beta || ply >= MAX_PLY) return best;
+        if (best > alpha) alpha = best;
+    } else if (ply >= MAX_PLY) {
+        return staticEval(board);
+    }
+    
+    // No standing pat in check: every evasion is tried, and having none is mate
+    MovePicker picker = inCheck ? MovePicker(board, Move(), Move(), Move(), nullptr) : MovePicker(board);
+    int moveCount = 0;
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        moveCount++;
+        playMove(board, move);
+        int score = -quiesce(board, -beta, -alpha, ply + 1);
+        takeBack(board);
+        if (stopped()) return 0;
+        
+        if (score > best) {
+            best = score;
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) break;
+        }
+    }
+    if (inCheck && moveCount == 0) return -MATE_SCORE + ply;
+    return best;
+}
+
+int Search::negamax(Board& board, int depthLeft, int alpha, int beta, int ply) {
+    if (depthLeft == 0) return quiesce(board, alpha, beta, ply);  // Counts the node itself
+    nodes++;
+    if (isMainThread && nodes % NODES_BETWEEN_TIME_CHECKS == 0) checkTime();
+    if (stopped()) return 0;  // Result is thrown away
+    
+    // A deep enough earlier result for this position may settle it straight away
+    Key key = board.getKey();
+    uint16_t tableMove = 0;
+    TranspositionTable::Entry entry;
+    if (probeTable(key, entry)) {
+        tableMove = entry.move;
+        if (entry.depth >= depthLeft) {
+            int score = scoreFromTable(entry.score, ply);
+            if (entry.bound == TranspositionTable::BOUND_EXACT) return score;
+            if (entry.bound == TranspositionTable::BOUND_LOWER && score >= beta) return score;
+            if (entry.bound == TranspositionTable::BOUND_UPPER && score <= alpha) return score;
+        }
+    }
+    
+    Colour us = board.getSideToMove();
+    MovePicker picker(board, Move::fromRaw(tableMove), killers[ply][0], killers[ply][1], history[colourIndex(us)]);
+    
+    int originalAlpha = alpha;
+    int best = -INFINITE_SCORE;
+    uint16_t bestMove = 0;
+    int moveCount = 0;
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        moveCount++;
+        bool quiet = board.pieceIndexAt(move.to()) == NO_PIECE && (move.kind() == Move::NORMAL || move.kind() == Move::CASTLING);
+        playMove(board, move);
+        int score = -negamax(board, depthLeft - 1, -beta, -alpha, ply + 1);
+        takeBack(board);
+        if (stopped()) return 0;
+        
+        if (score > best) {
+            best = score;
+            bestMove = move.raw();
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) {  // The opponent will never allow this line
+                if (quiet) rememberCutoff(us, move, depthLeft, ply);
+                break;
+            }
+        }
+    }
+    
+    // No legal moves: checkmate (prefer the quickest) or stalemate
+    if (moveCount == 0) {
+        return board.isInCheck(us) ? -MATE_SCORE + ply : 0;
+    }
+    
+    if (table) {
+        TranspositionTable::Bound bound = best >= beta ? TranspositionTable::BOUND_LOWER
+                                        : best > originalAlpha ? TranspositionTable::BOUND_EXACT
+                                        : TranspositionTable::BOUND_UPPER;
+        table->store(key, depthLeft, bound, scoreToTable(best, ply), bestMove);
+    }
+    return best;
+}
+
+int Search::searchRoot(Board& board, std::vector<Move>& rootMoves, int depth, size_t first) {
+    int alpha = -INFINITE_SCORE;
+    size_t bestIndex = first;
+    for (size_t i = first; i < rootMoves.size(); i++) {
+        playMove(board, rootMoves[i]);
+        int score = -negamax(board, depth - 1, -INFINITE_SCORE, -alpha, 1);
+        takeBack(board);
+        if (stopped()) break;
+        
+        if (score > alpha) {
+            alpha = score;
+            bestIndex = i;
+        }
+    }
+    
+    // Search the best move first next iteration
+    std::swap(rootMoves[first], rootMoves[bestIndex]);
+    return alpha;
+}
+
+std::vector<Move> Search::principalVariation(Board& board, Move rootMove, int maxLength) const {
+    std::vector<Move> line{rootMove};
+    std::vector<Key> seen{board.getKey()};
+    board.doMove(rootMove);
+    TranspositionTable::Entry entry;
+    while (table && static_cast<int>(line.size()) < maxLength && table->probe(board.getKey(), entry) && entry.move != 0) {
+        Move move = Move::fromRaw(entry.move);
+        if (!board.isLegal(move)) break;  // Entry of another position with the same key bits
+        seen.push_back(board.getKey());
+        board.doMove(move);
+        line.push_back(move);
+        if (std::find(seen.begin(), seen.end(), board.getKey()) != seen.end()) break;  // Going round in circles
+    }
+    for (size_t i = 0; i < line.size(); i++) board.undoMove();
+    return line;
+}
+
+void Search::rememberCutoff(Colour us, Move move, int depthLeft, int ply) {
+    if (killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+    
+    // Deep cutoffs count for more; halve everything before the counts can overflow
+    int& count = history[colourIndex(us)][move.from()][move.to()];
+    count += depthLeft * depthLeft;
+    if (count > HISTORY_LIMIT) {
+        for (auto& side : history) {
+            for (auto& from : side) {
+                for (int& value : from) value /= 2;
+            }
+        }
+    }
+}
+
+void Search::reset(const SearchLimits& searchLimits) {
+    limits = searchLimits;
+    startTime = budgetStart = std::chrono::steady_clock::now();
+    stopRequested = false;
+    stop = &stopRequested;
+    isMainThread = true;
+    nodes = tableProbes = tableHits = 0;
+    pawnProbes = pawnHits = 0;
+    evalProbes = evalHits = evaluations = 0;
+    if (accumulators) accumulators->reset();  // The board handed to the search is the root
+    completedDepth = 0;
+    bestScore = 0;
+    bestMove = Move();
+    lines.clear();
+    for (auto& plyKillers : killers) plyKillers[0] = plyKillers[1] = Move();
+    for (auto& side : history) {
+        for (auto& from : side) {
+            for (int& value : from) value = 0;
+        }
+    }
+}
+
+void Search::usePawnTable(int thread) {
+    if (pawnTables) {
+        pawnTable = &pawnTables->forThread(thread);  // Entries are kept: pawn structure carries over from move to move
+    } else {
+        if (!ownPawnTable) ownPawnTable = std::make_unique<PawnTable>();
+        pawnTable = ownPawnTable.get();
+    }
+    pawnTable->resetCounters();
+}
+
+void Search::iterate(Board& board, std::vector<Move> rootMoves, int startDepth) {
+    // Iterative deepening: each finished depth leaves its best move at the front
+    for (int depth = startDepth; depth <= limits.maxDepth; depth++) {
+        size_t lineCount = std::min<size_t>(std::max(limits.multiPV, 1), rootMoves.size());
+        std::vector<int> scores;
+        for (size_t first = 0; first < lineCount && !stopped(); first++) {
+            scores.push_back(searchRoot(board, rootMoves, depth, first));
+        }
+        if (stopped()) break;  // Unfinished iteration; only root moves it searched completely could replace the previous best
+        
+        int score = scores[0];
+        completedDepth = depth;
+        bestScore = score;
+        bestMove = rootMoves[0];
+        if (table) {
+            table->store(board.getKey(), depth, TranspositionTable::BOUND_EXACT, scoreToTable(score, 0), rootMoves[0].raw());
+        }
+        if (isMainThread) {
+            lines.clear();
+            for (size_t i = 0; i < lineCount; i++) {
+                PrincipalVariation line;
+                line.score = scores[i];
+                line.moves = principalVariation(board, rootMoves[i], depth);
+                lines.push_back(line);
+            }
+            if (progressCallback) {
+                SearchProgress progress;
+                progress.depth = depth;
+                progress.nodes = nodes;
+                progress.elapsedMs = elapsed();
+                progress.lines = lines;
+                progressCallback(progress);
+            }
+        }
+        
+        if (isMainThread && limits.softMs > 0 && !pondering() && budgetElapsed() >= limits.softMs) break;  // Next iteration would not finish in time
+        if (score > MATE_SCORE - 1000 || score < -MATE_SCORE + 1000) break;  // Forced mate found
+    }
+}
+
+Move Search::findBestMove(Board& board, const SearchLimits& searchLimits) {
+    reset(searchLimits);
+    usePawnTable(0);
+    
+    // Only legal moves at the root, so the answer is always playable
+    std::vector<Move> rootMoves;
+    board.generateLegalMoves(board.getSideToMove(), rootMoves);
+    if (rootMoves.empty()) return Move();
+    
+    TranspositionTable::Entry entry;
+    if (table) {
+        table->newSearch();
+        if (table->probe(board.getKey(), entry)) putTableMoveFirst(rootMoves, entry.move);
+    }
+    
+    // Lazy SMP helpers, each with its own board copy made before any thread starts.
+    // Odd helpers start one ply deeper so the threads are spread over neighbouring depths
+    // and fill the table with different results instead of all repeating the same work.
+    int helperCount = limits.threads > 1 ? limits.threads - 1 : 0;
+    std::vector<std::unique_ptr<Board>> helperBoards;
+    std::vector<std::unique_ptr<Search>> helpers;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < helperCount; i++) {
+        helperBoards.push_back(std::make_unique<Board>(board));
+        helpers.push_back(std::make_unique<Search>(table, evalCache, network, pawnTables));
+        Search& helper = *helpers.back();
+        helper.reset(limits);
+        helper.usePawnTable(i + 1);
+        helper.startTime = startTime;
+        helper.budgetStart = budgetStart;
+        helper.stop = &stopRequested;
+        helper.isMainThread = false;
+        threads.emplace_back(&Search::iterate, &helper, std::ref(*helperBoards.back()), rootMoves, 1 + (i % 2));
+    }
+    
+    iterate(board, rootMoves, 1);
+    stopRequested = true;  // The main thread decides when the search is over
+    for (std::thread& thread : threads) thread.join();
+    
+    // Play the move of whichever thread finished the deepest iteration (the main thread on ties)
+    for (const std::unique_ptr<Search>& helper : helpers) {
+        nodes += helper->nodes;
+        tableProbes += helper->tableProbes;
+        tableHits += helper->tableHits;
+        pawnProbes += helper->pawnTable->getProbes();
+        pawnHits += helper->pawnTable->getHits();
+        evalProbes += helper->evalProbes;
+        evalHits += helper->evalHits;
+        evaluations += helper->evaluations;
+        if (helper->completedDepth > completedDepth) {
+            completedDepth = helper->completedDepth;
+            bestScore = helper->bestScore;
+            bestMove = helper->bestMove;
+        }
+    }
+    
+    pawnProbes += pawnTable->getProbes();
+    pawnHits += pawnTable->getHits();
+    elapsedMs = elapsed();
+    return bestMove;
+}
@@ -0,0 +1,108 @@
+#include "transpositionTable.h"
+
+namespace {
+// Layout of a packed entry, low bits first:
+// key verification (16) | move (16) | score (16, signed) | depth (8) | bound (2) | generation (6)
+const int MOVE_SHIFT = 16;
+const int SCORE_SHIFT = 32;
+const int DEPTH_SHIFT = 48;
+const int BOUND_SHIFT = 56;
+const int GENERATION_SHIFT = 58;
+
+uint16_t verification(Key key) { return static_cast<uint16_t>(key >> 48); }
+
+uint64_t pack(Key key, uint16_t move, int score, int depth, TranspositionTable::Bound bound, uint8_t generation) {
+    return static_cast<uint64_t>(verification(key))
+         | static_cast<uint64_t>(move) << MOVE_SHIFT
+         | static_cast<uint64_t>(static_cast<uint16_t>(score)) << SCORE_SHIFT
+         | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << DEPTH_SHIFT
+         | static_cast<uint64_t>(bound) << BOUND_SHIFT
+         | static_cast<uint64_t>(generation) << GENERATION_SHIFT;
+}
+
+uint16_t keyOf(uint64_t data) { return static_cast<uint16_t>(data); }
+uint16_t moveOf(uint64_t data) { return static_cast<uint16_t>(data >> MOVE_SHIFT); }
+int scoreOf(uint64_t data) { return static_cast<int16_t>(data >> SCORE_SHIFT); }
+int depthOf(uint64_t data) { return static_cast<uint8_t>(data >> DEPTH_SHIFT); }
+TranspositionTable::Bound boundOf(uint64_t data) { return static_cast<TranspositionTable::Bound>((data >> BOUND_SHIFT) & 3); }
+uint8_t generationOf(uint64_t data) { return static_cast<uint8_t>(data >> GENERATION_SHIFT); }
+}
+
+TranspositionTable::TranspositionTable(int megabytes)
+    : bucketMask(0), sizeMB(0), generation(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(int megabytes) {
+    if (megabytes < 1) megabytes = 1;
+    
+    // Largest power-of-two bucket count that fits in the requested size
+    uint64_t bytes = static_cast<uint64_t>(megabytes) * 1024 * 1024;
+    uint64_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes) count *= 2;
+    
+    buckets.reset(new Bucket[count]);
+    bucketMask = count - 1;
+    sizeMB = megabytes;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i <= bucketMask; i++) {
+        for (std::atomic<uint64_t>& entry : buckets[i].entries) entry.store(0, std::memory_order_relaxed);
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & 63;
+}
+
+bool TranspositionTable::probe(Key key, Entry& entry) const {
+    const Bucket& bucket = bucketFor(key);
+    uint16_t check = verification(key);
+    
+    for (const std::atomic<uint64_t>& slot : bucket.entries) {
+        uint64_t data = slot.load(std::memory_order_relaxed);
+        if (data != 0 && keyOf(data) == check) {
+            entry.move = moveOf(data);
+            entry.score = scoreOf(data);
+            entry.depth = depthOf(data);
+            entry.bound = boundOf(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(Key key, int depth, Bound bound, int score, uint16_t move) {
+    Bucket& bucket = bucketFor(key);
+    uint16_t check = verification(key);
+    
+    // Reuse this position's slot if it has one, otherwise evict the least useful entry:
+    // stale entries from earlier searches first, then the shallowest.
+    std::atomic<uint64_t>* replace = &bucket.entries[0];
+    uint64_t replaced = replace->load(std::memory_order_relaxed);
+    int worstValue = 1 << 30;
+    for (std::atomic<uint64_t>& slot : bucket.entries) {
+        uint64_t data = slot.load(std::memory_order_relaxed);
+        if (data == 0 || keyOf(data) == check) {
+            replace = &slot;
+            replaced = data;
+            break;
+        }
+        int age = (generation - generationOf(data)) & 63;
+        int value = depthOf(data) - 8 * age;
+        if (value < worstValue) {
+            worstValue = value;
+            replace = &slot;
+            replaced = data;
+        }
+    }
+    
+    // Keep the old move if this search had none to offer for the same position
+    if (move == 0 && replaced != 0 && keyOf(replaced) == check) {
+        move = moveOf(replaced);
+    }
+    replace->store(pack(key, move, score, depth, bound, generation), std::memory_order_relaxed);
+}
@@ -0,0 +1,293 @@
+#include "uci.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <stdexcept>
+#include "gameClock.h"
+#include "position.h"
+
+using namespace std;
+
+namespace {
+const int MAX_HASH_MB = 4096;
+const int MAX_EVAL_CACHE_MB = 1024;
+const int MAX_MULTI_PV = 64;
+
+string lowercase(string text) {
+    for (char& c : text) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+// Coordinate notation with the promotion piece in lower case, as UCI wants it
+string uciMove(Move move) {
+    if (move.isNull()) return "0000";
+    return lowercase(move.toString());
+}
+
+// "e7e8q" on board, or the null move if it is not legal there
+Move parseMove(const Board& board, const string& text) {
+    if (text.size() < 4 || text.size() > 5) return Move();
+    for (int i = 0; i < 4; i += 2) {
+        if (text[i] < 'a' || text[i] > 'h' || text[i + 1] < '1' || text[i + 1] > '8') return Move();
+    }
+    Position from(text[1] - '0', text[0] - 'a' + 1);
+    Position to(text[3] - '0', text[2] - 'a' + 1);
+    Move move = board.moveFor(from, to, text.size() == 5 ? text[4] : 'q');
+    return board.isLegal(move) ? move : Move();
+}
+
+// Centipawns, or moves to mate (negative when being mated)
+string uciScore(int score) {
+    if (score > MATE_SCORE - 1000) return "mate " + to_string((MATE_SCORE - score + 1) / 2);
+    if (score < -MATE_SCORE + 1000) return "mate -" + to_string((MATE_SCORE + score + 1) / 2);
+    return "cp " + to_string(score);
+}
+
+int spinValue(const string& value, int low, int high) {
+    return clamp(stoi(value), low, high);  // stoi throws on anything that is not a number
+}
+}
+
+UciEngine::UciEngine()
+    : board(make_unique<Board>()), table(DEFAULT_HASH_MB), evalCache(DEFAULT_EVAL_CACHE_MB) {
+    board->setupStartingPosition();
+}
+
+UciEngine::~UciEngine() {
+    stopSearch = true;
+    pondering = false;
+    waitForSearch();
+}
+
+void UciEngine::send(const string& line) {
+    lock_guard<mutex> lock(outputMutex);
+    cout << line << endl;
+}
+
+// Run Loop ===================================================================
+
+void UciEngine::run() {
+    string command;
+    while (getline(cin, command)) {
+        try {
+            if (!handleCommand(command)) break;
+        } catch (const exception& e) {
+            send(string("info string Error: ") + e.what());
+        }
+    }
+    stopSearch = true;
+    pondering = false;
+    waitForSearch();
+}
+
+bool UciEngine::handleCommand(const string& command) {
+    istringstream iss(command);
+    string keyword;
+    iss >> keyword;
+
+    // Answered while a search runs
+    if (keyword == "quit") {
+        return false;
+
+    } else if (keyword == "stop") {
+        stopSearch = true;
+        return true;
+
+    } else if (keyword == "ponderhit") {    // The expected move was played: the ponder search becomes a normal one
+        pondering = false;
+        return true;
+
+    } else if (keyword == "isready") {
+        send("readyok");
+        return true;
+    }
+
+    waitForSearch();  // Anything else may change what the search is using
+    if (keyword == "uci") {
+        send("id name CS246 Chess");
+        send("id author CS246 Chess team");
+        send("option name Hash type spin default " + to_string(DEFAULT_HASH_MB) + " min 1 max " + to_string(MAX_HASH_MB));
+        send("option name EvalCache type spin default " + to_string(DEFAULT_EVAL_CACHE_MB) + " min 1 max " + to_string(MAX_EVAL_CACHE_MB));
+        send("option name Threads type spin default 1 min 1 max " + to_string(MAX_SEARCH_THREADS));
+        send("option name MultiPV type spin default 1 min 1 max " + to_string(MAX_MULTI_PV));
+        send("option name Ponder type check default false");
+        send("option name UseNNUE type check default false");
+        send("option name EvalFile type string default embedded");
+        send("uciok");
+
+    } else if (keyword == "ucinewgame") {
+        table.clear();
+        evalCache.clear();
+        pawnTables.clear();
+
+    } else if (keyword == "position") {    // position startpos moves e2e4 e7e5 / position fen <fen> moves ...
+        setPosition(iss);
+
+    } else if (keyword == "go") {    // go wtime 60000 btime 60000 winc 1000 binc 1000 / go depth 12 / go movetime 500
+        startSearch(iss);
+
+    } else if (keyword == "setoption") {    // setoption name Hash value 64
+        setOption(iss);
+
+    } else if (!keyword.empty()) {
+        send("info string Unknown command: " + keyword);
+    }
+    return true;
+}
+
+// Commands ===================================================================
+
+void UciEngine::setPosition(istringstream& in) {
+    string word;
+    in >> word;
+    auto next = make_unique<Board>();
+    if (word == "startpos") {
+        next->setupStartingPosition();
+        in >> word;
+    } else if (word == "fen") {
+        string fen;
+        while (in >> word && word != "moves") fen += (fen.empty() ? "" : " ") + word;
+        next->setFen(fen);  // Throws invalid_argument; the old position is kept
+        // setFen has made sure of one king a side and no pawns on the end ranks. Unlike
+        // isValidSetup, the side to move may be in check here, but the other side may not.
+        Colour waiting = next->getSideToMove() == Colour::WHITE ? Colour::BLACK : Colour::WHITE;
+        if (next->isInCheck(waiting)) throw runtime_error("Illegal position, the side not to move is in check: " + fen);
+    } else {
+        throw runtime_error("position needs startpos or fen");
+    }
+
+    if (word == "moves") {
+        while (in >> word) {
+            Move move = parseMove(*next, word);
+            if (move.isNull()) throw runtime_error("Illegal move " + word + ", position not changed");
+            next->makeMove(move);
+        }
+    }
+    board = move(next);
+}
+
+void UciEngine::setOption(istringstream& in) {
+    // Names may contain spaces and, like values, are read up to the next keyword
+    string word, name, value;
+    in >> word;
+    if (word != "name") throw runtime_error("setoption needs a name");
+    while (in >> word && word != "value") name += (name.empty() ? "" : " ") + word;
+    while (in >> word) value += (value.empty() ? "" : " ") + word;
+    name = lowercase(name);
+
+    if (name == "hash") {
+        table.resize(spinValue(value, 1, MAX_HASH_MB));
+    } else if (name == "evalcache") {
+        evalCache.resize(spinValue(value, 1, MAX_EVAL_CACHE_MB));
+    } else if (name == "threads") {
+        threads = spinValue(value, 1, MAX_SEARCH_THREADS);
+    } else if (name == "multipv") {
+        multiPV = spinValue(value, 1, MAX_MULTI_PV);
+    } else if (name == "ponder") {
+        // Only tells us the GUI may send go ponder; nothing to set up
+    } else if (name == "usennue") {
+        useNnue = lowercase(value) == "true";
+        loadNetwork();
+    } else if (name == "evalfile") {
+        evalFile = value.empty() ? "embedded" : value;
+        if (useNnue) loadNetwork();
+    } else {
+        send("info string Unknown option: " + name);
+    }
+}
+
+void UciEngine::loadNetwork() {
+    evalCache.clear();  // Scores from the other evaluator, whichever way this goes
+    if (!useNnue) {
+        network.reset();
+        return;
+    }
+    try {
+        network = evalFile == "embedded" ? NnueNetwork::embedded() : NnueNetwork::fromFile(evalFile);
+        send("info string NNUE network " + network->getSource() + " (" + NnueNetwork::kernelName() + ")");
+    } catch (const exception& e) {
+        network.reset();
+        send(string("info string ") + e.what() + ", using the hand-written evaluation");
+    }
+}
+
+// Search Thread ===================================================================
+
+void UciEngine::startSearch(istringstream& in) {
+    SearchLimits limits;
+    long long time[2] = {0, 0};
+    long long increment[2] = {0, 0};
+    int movesToGo = 0;
+    bool infinite = false, ponder = false;
+
+    string word;
+    while (in >> word) {
+        if (word == "infinite") infinite = true;
+        else if (word == "ponder") ponder = true;
+        else if (word == "wtime") in >> time[0];
+        else if (word == "btime") in >> time[1];
+        else if (word == "winc") in >> increment[0];
+        else if (word == "binc") in >> increment[1];
+        else if (word == "movestogo") in >> movesToGo;
+        else if (word == "movetime") in >> limits.hardMs;
+        else if (word == "nodes") in >> limits.maxNodes;
+        else if (word == "depth") {
+            int depth = limits.maxDepth;
+            in >> depth;
+            limits.maxDepth = clamp(depth, 1, limits.maxDepth);
+        }
+        // Anything else (searchmoves, mate) is not supported and skipped
+    }
+
+    int us = board->getSideToMove() == Colour::WHITE ? 0 : 1;
+    if (limits.hardMs > 0) {
+        limits.softMs = limits.hardMs;  // movetime: use all of it
+    } else if (time[us] > 0 && !infinite) {
+        SearchLimits budget = budgetFor(time[us], increment[us], movesToGo);
+        limits.softMs = budget.softMs;
+        limits.hardMs = budget.hardMs;
+    }
+    limits.threads = threads;
+    limits.multiPV = multiPV;
+    limits.stopSignal = &stopSearch;
+    if (ponder) limits.ponder = &pondering;
+
+    stopSearch = false;
+    pondering = ponder;
+    auto root = make_unique<Board>(*board);
+    searchThread = thread([this, limits, infinite, root = move(root)] { think(*root, limits, infinite); });
+}
+
+void UciEngine::think(Board& root, SearchLimits limits, bool infinite) {
+    Search search(&table, &evalCache, network.get(), &pawnTables);
+    search.setProgressCallback([this](const SearchProgress& progress) {
+        // One line per principal variation, built in full so printing is a single write
+        long long nps = progress.elapsedMs > 0 ? progress.nodes * 1000 / progress.elapsedMs : progress.nodes * 1000;
+        for (size_t i = 0; i < progress.lines.size(); i++) {
+            const PrincipalVariation& line = progress.lines[i];
+            string info = "info depth " + to_string(progress.depth) + " multipv " + to_string(i + 1) +
+                          " score " + uciScore(line.score) + " nodes " + to_string(progress.nodes) +
+                          " nps " + to_string(nps) + " time " + to_string(progress.elapsedMs) + " pv";
+            for (Move move : line.moves) info += " " + uciMove(move);
+            send(info);
+        }
+    });
+    Move best = search.findBestMove(root, limits);
+
+    // The protocol holds bestmove back until stop (or ponderhit) even if the search ended by itself
+    while (!stopSearch && (infinite || pondering)) this_thread::sleep_for(chrono::milliseconds(1));
+
+    string answer = "bestmove " + uciMove(best);
+    const vector<PrincipalVariation>& lines = search.getLines();
+    if (!best.isNull() && !lines.empty() && lines[0].moves.size() >= 2 && lines[0].moves[0] == best) {
+        answer += " ponder " + uciMove(lines[0].moves[1]);
+    }
+    send(answer);
+}
+
+void UciEngine::waitForSearch() {
+    if (searchThread.joinable()) searchThread.join();
+}
@@ -0,0 +1,35 @@
+#include "zobrist.h"
+
+ZobristKeys zobrist;
+
+namespace {
+bool buildZobristKeys() {
+    // Fixed seed so keys (and anything stored under them) are the same every run
+    uint64_t state = 1070372ULL;
+    auto next = [&state]() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    };
+    
+    for (int piece = 0; piece < 12; piece++) {
+        for (int square = 0; square < 64; square++) {
+            zobrist.pieceSquare[piece][square] = next();
+        }
+    }
+    for (int rights = 0; rights < 16; rights++) {
+        zobrist.castling[rights] = next();
+    }
+    for (int file = 0; file < 8; file++) {
+        zobrist.enPassant[file] = next();
+    }
+    zobrist.blackToMove = next();
+    return true;
+}
+}
+
+void initZobrist() {
+    static const bool built = buildZobristKeys();  // Thread-safe, runs exactly once
+    (void)built;
+}